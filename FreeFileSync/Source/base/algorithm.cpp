@@ -13,6 +13,7 @@
 #include <zen/file_access.h> //needed for TempFileBuffer only
 #include <zen/serialize.h>
 #include "norm_filter.h"
+#include "binary.h"
 #include "db_file.h"
 #include "cmp_filetime.h"
 #include "status_handler_impl.h"
@@ -225,14 +226,16 @@ bool stillInSync(const InSyncFile& dbFile, CompareVariant compareVar, int fileTi
     switch (compareVar)
     {
         case CompareVariant::TIME_SIZE:
-            if (dbFile.cmpVar == CompareVariant::CONTENT) return true; //special rule: this is certainly "good enough" for CompareVariant::TIME_SIZE!
+            if (dbFile.cmpVar == CompareVariant::CONTENT ||
+                dbFile.cmpVar == CompareVariant::CONTENT_CACHED) return true; //special rule: this is certainly "good enough" for CompareVariant::TIME_SIZE!
 
             //case-sensitive short name match is a database invariant!
             return sameFileTime(dbFile.left.modTime, dbFile.right.modTime, fileTimeTolerance, ignoreTimeShiftMinutes);
 
         case CompareVariant::CONTENT:
+        case CompareVariant::CONTENT_CACHED:
             //case-sensitive short name match is a database invariant!
-            return dbFile.cmpVar == CompareVariant::CONTENT;
+            return dbFile.cmpVar == CompareVariant::CONTENT || dbFile.cmpVar == CompareVariant::CONTENT_CACHED;
         //in contrast to comparison, we don't care about modification time here!
 
         case CompareVariant::SIZE: //file size/case-sensitive short name always matches on both sides for an "in-sync" database entry
@@ -276,7 +279,7 @@ bool stillInSync(const InSyncSymlink& dbLink, CompareVariant compareVar, int fil
     switch (compareVar)
     {
         case CompareVariant::TIME_SIZE:
-            if (dbLink.cmpVar == CompareVariant::CONTENT || dbLink.cmpVar == CompareVariant::SIZE)
+            if (dbLink.cmpVar != CompareVariant::TIME_SIZE)
                 return true; //special rule: this is already "good enough" for CompareVariant::TIME_SIZE!
 
             //case-sensitive short name match is a database invariant!
@@ -284,8 +287,9 @@ bool stillInSync(const InSyncSymlink& dbLink, CompareVariant compareVar, int fil
 
         case CompareVariant::CONTENT:
         case CompareVariant::SIZE: //== categorized by content! see comparison.cpp, ComparisonBuffer::compareBySize()
+        case CompareVariant::CONTENT_CACHED:
             //case-sensitive short name match is a database invariant!
-            return dbLink.cmpVar == CompareVariant::CONTENT || dbLink.cmpVar == CompareVariant::SIZE;
+            return dbLink.cmpVar != CompareVariant::TIME_SIZE;
     }
     assert(false);
     return false;
@@ -749,6 +753,232 @@ void fff::redetermineSyncDirection(const MainConfiguration& mainCfg, //throw Fil
 
 //---------------------------------------------------------------------------------------------------------------
 
+namespace
+{
+using MoveCandidates = std::pair<std::vector<FilePair*>, std::vector<FilePair*>>; //left only, right only
+
+const size_t MOVE_DETECTION_SAMPLE_SIZE = 64 * 1024;
+
+
+void collectMoveCandidates(ContainerObject& hierObj, uint64_t fileSizeMin, std::map<uint64_t /*file size*/, MoveCandidates>& candidates)
+{
+    for (FilePair& file : hierObj.refSubFiles())
+        if (file.getMoveRef() == nullptr) //not yet part of a move pair, e.g. found via database
+        {
+            const CompareFilesResult cat = file.getCategory();
+            if (cat == FILE_LEFT_SIDE_ONLY)
+            {
+                if (file.getFileSize<LEFT_SIDE>() >= fileSizeMin && !endsWith(file.getItemName<LEFT_SIDE>(), AFS::TEMP_FILE_ENDING))
+                    candidates[file.getFileSize<LEFT_SIDE>()].first.push_back(&file);
+            }
+            else if (cat == FILE_RIGHT_SIDE_ONLY)
+            {
+                if (file.getFileSize<RIGHT_SIDE>() >= fileSizeMin && !endsWith(file.getItemName<RIGHT_SIDE>(), AFS::TEMP_FILE_ENDING))
+                    candidates[file.getFileSize<RIGHT_SIDE>()].second.push_back(&file);
+            }
+        }
+
+    for (FolderPair& folder : hierObj.refSubFolders())
+        collectMoveCandidates(folder, fileSizeMin, candidates);
+}
+
+
+void setMovePair(FilePair& fileLeftOnly, FilePair& fileRightOnly)
+{
+    fileLeftOnly .setMoveRef(fileRightOnly.getId()); //found a pair, mark it!
+    fileRightOnly.setMoveRef(fileLeftOnly .getId()); //
+}
+
+
+class MoveDetector
+{
+public:
+    MoveDetector(const std::map<AbstractPath, size_t>& deviceParallelOps, ProcessCallback& callback) :
+        deviceParallelOps_(deviceParallelOps), callback_(callback) {}
+
+    //split groups by content digest; only groups with candidates on both sides are kept
+    std::vector<MoveCandidates> groupByDigest(const std::vector<MoveCandidates>& groups, bool headOnly) //throw X
+    {
+        std::vector<std::map<uint64_t /*digest*/, MoveCandidates>> groupsByDigest(groups.size());
+
+        //left side first: right side is only read for groups where at least one left file could be read
+        std::vector<std::pair<FilePair*, size_t /*group*/>> filesL;
+        for (size_t i = 0; i < groups.size(); ++i)
+            for (FilePair* file : groups[i].first)
+                filesL.emplace_back(file, i);
+
+        const std::vector<std::optional<uint64_t>> digestsL = getDigests<LEFT_SIDE>(filesL, headOnly); //throw X
+        for (size_t i = 0; i < filesL.size(); ++i)
+            if (digestsL[i])
+                groupsByDigest[filesL[i].second][*digestsL[i]].first.push_back(filesL[i].first);
+
+        std::vector<std::pair<FilePair*, size_t /*group*/>> filesR;
+        for (size_t i = 0; i < groups.size(); ++i)
+            if (!groupsByDigest[i].empty())
+                for (FilePair* file : groups[i].second)
+                    filesR.emplace_back(file, i);
+
+        const std::vector<std::optional<uint64_t>> digestsR = getDigests<RIGHT_SIDE>(filesR, headOnly); //throw X
+        for (size_t i = 0; i < filesR.size(); ++i)
+            if (digestsR[i])
+                if (auto it = groupsByDigest[filesR[i].second].find(*digestsR[i]); it != groupsByDigest[filesR[i].second].end())
+                    it->second.second.push_back(filesR[i].first);
+
+        std::vector<MoveCandidates> output;
+        for (auto& byDigest : groupsByDigest)
+            for (auto& [digest, candidates] : byDigest)
+                if (!candidates.second.empty())
+                    output.push_back(std::move(candidates));
+        return output;
+    }
+
+    //1:1 candidates: byte-wise comparison stops at the first difference and doesn't rely on a 64-bit digest
+    std::vector<char /*bool*/> haveSameContent(const std::vector<std::pair<FilePair*, FilePair*>>& filePairs) //throw X
+    {
+        std::vector<char> output(filePairs.size()); //not std::vector<bool>: written concurrently
+        if (filePairs.empty())
+            return output;
+        std::vector<std::pair<AbstractPath, ParallelWorkItem>> workload;
+
+        for (size_t i = 0; i < filePairs.size(); ++i)
+        {
+            const FilePair& fileL = *filePairs[i].first;
+            const FilePair& fileR = *filePairs[i].second;
+
+            workload.emplace_back(fileL.getAbstractPath<LEFT_SIDE>(), [&fileL, &fileR, &sameContent = output[i], &txt = txtComparingContent_](ParallelContext& ctx) //throw ThreadInterruption
+            {
+                ctx.acb.reportStatus(replaceCpy(txt, L"%x", fmtPath(AFS::getDisplayPath(fileL.getAbstractPath<LEFT_SIDE>())))); //throw ThreadInterruption
+
+                const int64_t bytesExpected = 2 * static_cast<int64_t>(fileL.getFileSize<LEFT_SIDE>());
+                ctx.acb.updateDataTotal(0, bytesExpected); //not part of the comparison phase's initial estimate
+                AsyncItemStatReporter statReporter(0, bytesExpected, ctx.acb);
+                try
+                {
+                    sameContent = filesHaveSameContent(fileL.getAbstractPath<LEFT_SIDE>(), fileR.getAbstractPath<RIGHT_SIDE>(), //throw FileError, ThreadInterruption
+                                                       [&](int64_t bytesDelta) { statReporter.reportDelta(0, bytesDelta); interruptionPoint(); }); //throw ThreadInterruption
+                }
+                catch (FileError&) {} //not an error in this context: file will be copied/deleted instead of moved => error is reported during sync
+            });
+        }
+        massParallelExecute(workload, deviceParallelOps_, 0 /*adaptiveParallelOpsMax*/, "Detect Moved Files", callback_ /*throw X*/);
+        return output;
+    }
+
+private:
+    //read files in parallel: "deviceParallelOps" per device
+    template <SelectedSide side>
+    std::vector<std::optional<uint64_t>> getDigests(const std::vector<std::pair<FilePair*, size_t>>& files, bool headOnly) //throw X
+    {
+        std::vector<std::optional<uint64_t>> output(files.size()); //no value: read error
+        if (files.empty())
+            return output;
+        std::vector<std::pair<AbstractPath, ParallelWorkItem>> workload;
+
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            const FilePair& file = *files[i].first;
+
+            workload.emplace_back(file.getAbstractPath<side>(), [&file, headOnly, &digest = output[i], &txt = txtComparingContent_](ParallelContext& ctx) //throw ThreadInterruption
+            {
+                const uint64_t fileSize = file.getFileSize<side>();
+                ctx.acb.reportStatus(replaceCpy(txt, L"%x", fmtPath(AFS::getDisplayPath(ctx.itemPath)))); //throw ThreadInterruption
+
+                const int64_t bytesExpected = headOnly ? std::min<uint64_t>(fileSize, MOVE_DETECTION_SAMPLE_SIZE) : fileSize;
+                ctx.acb.updateDataTotal(0, bytesExpected); //not part of the comparison phase's initial estimate
+                AsyncItemStatReporter statReporter(0, bytesExpected, ctx.acb);
+                auto notifyUnbufferedIO = [&](int64_t bytesDelta) { statReporter.reportDelta(0, bytesDelta); interruptionPoint(); }; //throw ThreadInterruption
+                try
+                {
+                    digest = headOnly ?
+                             getFileHeadDigest(ctx.itemPath, MOVE_DETECTION_SAMPLE_SIZE, notifyUnbufferedIO) : //throw FileError, ThreadInterruption
+                             getFileContentDigest(ctx.itemPath, notifyUnbufferedIO);                            //
+                }
+                catch (FileError&) {} //not an error in this context: file will be copied/deleted instead of moved => error is reported during sync
+            });
+        }
+        massParallelExecute(workload, deviceParallelOps_, 0 /*adaptiveParallelOpsMax*/, "Detect Moved Files", callback_ /*throw X*/);
+        return output;
+    }
+
+    const std::map<AbstractPath, size_t>& deviceParallelOps_;
+    ProcessCallback& callback_;
+    const std::wstring txtComparingContent_ = _("Comparing content of files %x");
+};
+}
+
+
+void fff::detectMovedFilesByContent(BaseFolderPair& baseFolder, uint64_t fileSizeMin, const std::map<AbstractPath, size_t>& deviceParallelOps, ProcessCallback& callback) //throw X
+{
+    std::map<uint64_t /*file size*/, MoveCandidates> candidatesBySize;
+    collectMoveCandidates(baseFolder, std::max<uint64_t>(fileSizeMin, 1), candidatesBySize);
+
+    //CompareVariant::TIME_SIZE: moved file would be reported as different after sync unless modification times match
+    const bool matchTime = baseFolder.getCompVariant() == CompareVariant::TIME_SIZE;
+    auto sameTime = [&](const FilePair* fileL, const FilePair* fileR)
+    {
+        return sameFileTime(fileL->getLastWriteTime<LEFT_SIDE>(), fileR->getLastWriteTime<RIGHT_SIDE>(), baseFolder.getFileTimeTolerance(), baseFolder.getIgnoredTimeShift());
+    };
+
+    std::vector<std::pair<FilePair*, FilePair*>> compareOneToOne;
+    std::vector<MoveCandidates> groupsSmall; //hash of file beginning would read the full file anyway
+    std::vector<MoveCandidates> groupsLarge;
+
+    for (auto& [fileSize, candidates] : candidatesBySize)
+    {
+        auto& [leftOnly, rightOnly] = candidates;
+
+        if (leftOnly.empty() || rightOnly.empty()) //file size found on one side only: no I/O needed
+            continue;
+
+        if (matchTime) //don't spend I/O on files that can't be paired anyway
+        {
+            auto itL = std::remove_if(leftOnly.begin(), leftOnly.end(), [&](const FilePair* fileL)
+            { return std::none_of(rightOnly.begin(), rightOnly.end(), [&](const FilePair* fileR) { return sameTime(fileL, fileR); }); });
+
+            auto itR = std::remove_if(rightOnly.begin(), rightOnly.end(), [&](const FilePair* fileR)
+            { return std::none_of(leftOnly.begin(), leftOnly.end(), [&](const FilePair* fileL) { return sameTime(fileL, fileR); }); });
+
+            leftOnly .erase(itL, leftOnly .end());
+            rightOnly.erase(itR, rightOnly.end());
+        }
+
+        if (leftOnly.empty() || rightOnly.empty())
+            continue;
+        else if (leftOnly.size() == 1 && rightOnly.size() == 1)
+            compareOneToOne.emplace_back(leftOnly[0], rightOnly[0]);
+        else if (fileSize > MOVE_DETECTION_SAMPLE_SIZE)
+            groupsLarge.push_back(std::move(candidates));
+        else
+            groupsSmall.push_back(std::move(candidates));
+    }
+
+    MoveDetector detector(deviceParallelOps, callback);
+
+    //1. cheap: hash of file beginning only
+    for (MoveCandidates& candidates : detector.groupByDigest(groupsLarge, true /*headOnly*/)) //throw X
+        if (candidates.first.size() == 1 && candidates.second.size() == 1)
+            compareOneToOne.emplace_back(candidates.first[0], candidates.second[0]);
+        else
+            groupsSmall.push_back(std::move(candidates));
+
+    //2. full content hash for ambiguous groups
+    for (const MoveCandidates& candidates : detector.groupByDigest(groupsSmall, false /*headOnly*/)) //throw X
+        if (candidates.first.size() == 1 && candidates.second.size() == 1) //allow 1-1 mapping only: avoid ambiguity for duplicate files
+            compareOneToOne.emplace_back(candidates.first[0], candidates.second[0]); //don't trust a 64-bit digest alone
+
+    //3. 1:1 candidates: byte-wise comparison
+    if (matchTime)
+        compareOneToOne.erase(std::remove_if(compareOneToOne.begin(), compareOneToOne.end(), [&](const auto& item) { return !sameTime(item.first, item.second); }),
+                              compareOneToOne.end());
+
+    const std::vector<char> sameContent = detector.haveSameContent(compareOneToOne); //throw X
+    for (size_t i = 0; i < compareOneToOne.size(); ++i)
+        if (sameContent[i])
+            setMovePair(*compareOneToOne[i].first, *compareOneToOne[i].second);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
 struct SetNewDirection
 {
     static void execute(FilePair& file, SyncDirection newDirection)
@@ -1314,7 +1544,7 @@ void copyToAlternateFolderFrom(const std::vector<const FileSystemObject*>& rowsT
                     callback.requestUiRefresh(); //throw X
                 };
                 /*const AFS::FileCopyResult result =*/ AFS::copyFileTransactional(sourcePath, sourceAttr, targetPath, //throw FileError, ErrorFileLocked
-                                                                                  false /*copyFilePermissions*/, true /*transactionalCopy*/, deleteTargetItem, notifyUnbufferedIO);
+                                                                                  false /*copyFilePermissions*/, true /*transactionalCopy*/, FileCopyOptions(), deleteTargetItem, notifyUnbufferedIO);
                 //result.errorModTime? => probably irrelevant (behave like Windows Explorer)
             });
             statReporter.reportDelta(1, 0);
@@ -1711,7 +1941,7 @@ void TempFileBuffer::createTempFiles(const std::set<FileDescriptor>& workLoad, P
             };
             /*const AFS::FileCopyResult result =*/ AFS::copyFileTransactional(descr.path, sourceAttr, //throw FileError, ErrorFileLocked
                                                                               createItemPathNative(tempFilePath),
-                                                                              false /*copyFilePermissions*/, true /*transactionalCopy*/, nullptr /*onDeleteTargetFile*/, notifyUnbufferedIO);
+                                                                              false /*copyFilePermissions*/, true /*transactionalCopy*/, FileCopyOptions(), nullptr /*onDeleteTargetFile*/, notifyUnbufferedIO);
             //result.errorModTime? => irrelevant for temp files!
             statReporter.reportDelta(1, 0);
 
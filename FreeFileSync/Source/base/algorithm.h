@@ -28,6 +28,10 @@ void redetermineSyncDirection(const MainConfiguration& mainCfg, //throw FileErro
                               FolderComparison& folderCmp,
                               const std::function<void(const std::wstring& msg)>& notifyStatus);
 
+//complement database-based move detection, e.g. first sync or file ids differing across devices: pair left-only/right-only files by
+//content (same size, hash of file beginning, byte-wise comparison); reads candidate files of at least "fileSizeMin" bytes using "deviceParallelOps"!
+void detectMovedFilesByContent(BaseFolderPair& baseFolder, uint64_t fileSizeMin, const std::map<AbstractPath, size_t>& deviceParallelOps, ProcessCallback& callback); //throw X
+
 void setSyncDirectionRec(SyncDirection newDirection, FileSystemObject& fsObj); //set new direction (recursively)
 
 bool allElementsEqual(const FolderComparison& folderCmp);
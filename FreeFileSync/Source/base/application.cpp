@@ -7,6 +7,7 @@
 #include "application.h"
 #include <memory>
 #include <zen/file_access.h>
+#include <zen/file_io.h>
 #include <zen/perf.h>
 #include <wx/tooltip.h>
 #include <wx/log.h>
@@ -539,6 +540,8 @@ void runBatchMode(const Zstring& globalConfigFilePath, const XmlBatchConfig& bat
         //continue!
     }
 
+    enableAsyncFileIo(globalCfg.asyncFileIo);
+
     //all settings have been read successfully...
 
     //regular check for program updates -> disabled for batch
@@ -585,6 +588,9 @@ void runBatchMode(const Zstring& globalConfigFilePath, const XmlBatchConfig& bat
                                              dirLocks,
                                              extractCompareCfg(batchCfg.mainCfg),
                                              deviceParallelOps,
+                                             globalCfg.adaptiveParallelOps ? globalCfg.adaptiveParallelOpsMax : 0,
+                                             globalCfg.incrementalScan ? std::max<size_t>(globalCfg.incrementalScanFullRescanInterval, 1) : 0,
+                                             globalCfg.detectMovedFilesByContent ? std::max<uint64_t>(globalCfg.detectMovedFilesByContentMinSizeMB * 1024 * 1024ULL, 1) : 0,
                                              statusHandler); //throw AbortProcess
         //START SYNCHRONIZATION
         synchronize(syncStartTime,
@@ -592,11 +598,16 @@ void runBatchMode(const Zstring& globalConfigFilePath, const XmlBatchConfig& bat
                     globalCfg.copyLockedFiles,
                     globalCfg.copyFilePermissions,
                     globalCfg.failSafeFileCopy,
+                    globalCfg.cacheNeutralFileCopy,
+                    static_cast<uint64_t>(globalCfg.directIoMinSizeMB) * 1024 * 1024,
+                    static_cast<uint64_t>(globalCfg.chunkedCopyMinSizeMB) * 1024 * 1024,
                     globalCfg.runWithBackgroundPriority,
                     globalCfg.folderAccessTimeout,
                     extractSyncCfg(batchCfg.mainCfg),
                     cmpResult,
                     deviceParallelOps,
+                    globalCfg.adaptiveParallelOps ? globalCfg.adaptiveParallelOpsMax : 0,
+                    batchCfg.mainCfg.deviceCopyBuffers,
                     globalCfg.warnDlgs,
                     statusHandler); //throw AbortProcess
     }
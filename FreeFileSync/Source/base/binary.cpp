@@ -7,6 +7,13 @@
 #include "binary.h"
 #include <vector>
 #include <chrono>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <zen/xxhash.h>
+#include <zen/scope_guard.h>
+#include <zen/thread.h>
+#include <zen/file_io.h>
 
 using namespace zen;
 using namespace fff;
@@ -91,21 +98,134 @@ private:
     std::chrono::steady_clock::time_point lastDelayViolation_ = std::chrono::steady_clock::now();
     bool eof_ = false;
 };
+
+
+//prefetch chunks of a StreamReader on a worker thread: allow two devices to read at the same time
+class AsyncStreamReader
+{
+public:
+    AsyncStreamReader(const AbstractPath& filePath, const IOCallback& notifyUnbufferedIO /*thread-safe!*/, //throw FileError, X
+                      const std::function<void()>& onUpdate /*throw X*/) :
+        reader_(filePath, notifyUnbufferedIO), //throw FileError, X
+        onUpdate_(onUpdate),
+        worker_([this] { setCurrentThreadName("Binary Compare Reader"); readAhead(); }) {}
+
+    ~AsyncStreamReader()
+    {
+        worker_.interrupt(); //e.g. files differ or user cancel: don't wait for the remaining read-ahead
+        worker_.join();
+    }
+
+    void appendChunk(std::vector<std::byte>& buffer) //throw FileError, X
+    {
+        assert(!isEof());
+        std::vector<std::byte> chunk;
+        {
+            std::unique_lock<std::mutex> dummy(lockChunks_);
+            //give caller a chance to report progress from the worker thread:
+            while (!conditionChunkAdded_.wait_for(dummy, std::chrono::milliseconds(100), [&] { return !chunks_.empty() || readError_ || readerEof_; }))
+            {
+                dummy.unlock();
+                onUpdate_(); //throw X
+                dummy.lock();
+            }
+            if (chunks_.empty())
+            {
+                if (readError_)
+                    std::rethrow_exception(readError_); //throw FileError
+                return; //readerEof_: already reported via last chunk
+            }
+            chunk = std::move(chunks_.front());
+            chunks_.pop_front();
+            eof_ = chunks_.empty() && readerEof_;
+        }
+        conditionChunkTaken_.notify_all();
+        onUpdate_(); //throw X
+
+        if (buffer.empty())
+            buffer.swap(chunk);
+        else
+            buffer.insert(buffer.end(), chunk.begin(), chunk.end());
+    }
+
+    bool isEof() const { return eof_; }
+
+private:
+    AsyncStreamReader           (const AsyncStreamReader&) = delete;
+    AsyncStreamReader& operator=(const AsyncStreamReader&) = delete;
+
+    void readAhead() //context of worker thread
+    {
+        try
+        {
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> dummy(lockChunks_);
+                    interruptibleWait(conditionChunkTaken_, dummy, [&] { return chunks_.size() < READ_AHEAD_CHUNKS; }); //throw ThreadInterruption
+                }
+                std::vector<std::byte> chunk;
+                reader_.appendChunk(chunk); //throw FileError; adaptive block size is still measured for the read alone
+                const bool eof = reader_.isEof();
+                {
+                    std::lock_guard<std::mutex> dummy(lockChunks_);
+                    chunks_.push_back(std::move(chunk));
+                    readerEof_ = eof;
+                }
+                conditionChunkAdded_.notify_all();
+
+                if (eof)
+                    return;
+            }
+        }
+        catch (ThreadInterruption&) { throw; }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> dummy(lockChunks_);
+                readError_ = std::current_exception();
+            }
+            conditionChunkAdded_.notify_all();
+        }
+    }
+
+    static constexpr size_t READ_AHEAD_CHUNKS = 2; //bounded memory: each chunk is at most BLOCK_SIZE_MAX
+
+    StreamReader reader_; //accessed by worker thread only (after construction)
+    const std::function<void()> onUpdate_;
+
+    std::mutex lockChunks_;
+    std::condition_variable conditionChunkAdded_;
+    std::condition_variable conditionChunkTaken_;
+    std::deque<std::vector<std::byte>> chunks_;
+    bool readerEof_ = false;
+    std::exception_ptr readError_;
+
+    bool eof_ = false; //context of owning thread
+
+    InterruptibleThread worker_; //initialize last!
+};
 }
 
 
-bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, const IOCallback& notifyUnbufferedIO) //throw FileError
+bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, const IOCallback& notifyUnbufferedIO, uint64_t* contentDigest) //throw FileError
 {
     int64_t totalUnbufferedIO = 0;
 
-    StreamReader reader1(filePath1, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //throw FileError, X
-    StreamReader reader2(filePath2, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //
+    //both files are read concurrently: report I/O on this thread
+    IOCallbackAsync notifyReadAsync(IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO));
+    const std::function<void()> onUpdate = [&] { notifyReadAsync.flush(); /*throw X*/ };
+    ZEN_ON_SCOPE_SUCCESS(notifyReadAsync.flush()); //throw X; also for early return (content mismatch): after readers are joined (declared later)
 
-    StreamReader* readerLow  = &reader1;
-    StreamReader* readerHigh = &reader2;
+    AsyncStreamReader reader1(filePath1, notifyReadAsync.getCallback(), onUpdate); //throw FileError, X
+    AsyncStreamReader reader2(filePath2, notifyReadAsync.getCallback(), onUpdate); //
+
+    AsyncStreamReader* readerLow  = &reader1;
+    AsyncStreamReader* readerHigh = &reader2;
 
     std::vector<std::byte> bufferLow;
     std::vector<std::byte> bufferHigh;
+    XxHash64 hasher; //content of the common prefix compared so far
 
     for (;;)
     {
@@ -121,6 +241,9 @@ bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath
                         bufferHigh.begin()))
             return false;
 
+        if (contentDigest)
+            hasher.update(bufferLow.data(), bufferLow.size());
+
         if (readerLow->isEof())
         {
             if (bufferLow.size() < bufferHigh.size())
@@ -136,8 +259,82 @@ bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath
         bufferLow.clear();
     }
 
+    notifyReadAsync.flush(); //throw X
+
     if (totalUnbufferedIO % 2 != 0)
         throw std::logic_error("Contract violation! " + std::string(__FILE__) + ":" + numberTo<std::string>(__LINE__));
 
+    if (contentDigest)
+        *contentDigest = hasher.finalize();
     return true;
 }
+
+
+uint64_t fff::getFileContentDigest(const AbstractPath& filePath, const IOCallback& notifyUnbufferedIO) //throw FileError
+{
+    StreamReader reader(filePath, notifyUnbufferedIO); //throw FileError, X
+
+    XxHash64 hasher;
+    std::vector<std::byte> buffer;
+    while (!reader.isEof())
+    {
+        reader.appendChunk(buffer); //throw FileError, X
+        hasher.update(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+    return hasher.finalize();
+}
+
+
+uint64_t fff::getFileHeadDigest(const AbstractPath& filePath, size_t bytesMax, const IOCallback& notifyUnbufferedIO) //throw FileError
+{
+    const std::unique_ptr<AFS::InputStream> stream = AFS::getInputStream(filePath, notifyUnbufferedIO); //throw FileError, ErrorFileLocked, X
+
+    std::vector<std::byte> buffer(bytesMax);
+    buffer.resize(stream->read(buffer.data(), buffer.size())); //throw FileError, ErrorFileLocked, X; return "bytesToRead" bytes unless end of stream!
+
+    XxHash64 hasher;
+    hasher.update(buffer.data(), buffer.size());
+    return hasher.finalize();
+}
+
+
+std::optional<bool> fff::fileSamplesMatch(const AbstractPath& filePath1, const AbstractPath& filePath2, uint64_t fileSize) //throw FileError
+{
+    //many differing files differ at the beginning (header) or at the end (appended data)
+    //=> a few KB are enough, but the stream abstraction can't seek: restrict to native files
+    const std::optional<Zstring> nativePath1 = AFS::getNativeItemPath(filePath1);
+    const std::optional<Zstring> nativePath2 = AFS::getNativeItemPath(filePath2);
+    if (!nativePath1 || !nativePath2)
+        return {};
+
+    auto readSamples = [&](const Zstring& filePath) //throw FileError
+    {
+        FileInput fileIn(filePath, nullptr /*notifyUnbufferedIO*/); //throw FileError, ErrorFileLocked
+
+        std::vector<std::byte> buffer;
+        if (fileSize <= 2 * FILE_SAMPLE_SIZE) //read full content => final result; +1 byte: detect file growing in the meantime
+        {
+            buffer.resize(static_cast<size_t>(fileSize) + 1);
+            buffer.resize(fileIn.readAt(0, buffer.data(), buffer.size())); //throw FileError
+        }
+        else
+        {
+            buffer.resize(2 * FILE_SAMPLE_SIZE);
+            size_t bytesRead = fileIn.readAt(0, buffer.data(), FILE_SAMPLE_SIZE); //throw FileError
+            if (bytesRead == FILE_SAMPLE_SIZE) //else: file was truncated in the meantime
+                bytesRead += fileIn.readAt(fileSize - FILE_SAMPLE_SIZE, buffer.data() + FILE_SAMPLE_SIZE, FILE_SAMPLE_SIZE); //throw FileError
+            buffer.resize(bytesRead);
+        }
+        return buffer;
+    };
+
+    const std::vector<std::byte> samples1 = readSamples(*nativePath1); //throw FileError
+    const std::vector<std::byte> samples2 = readSamples(*nativePath2); //
+
+    if (fileSize <= 2 * FILE_SAMPLE_SIZE &&
+        (samples1.size() != fileSize || samples2.size() != fileSize)) //file size changed in the meantime => let filesHaveSameContent() decide
+        return {};
+
+    return samples1 == samples2;
+}
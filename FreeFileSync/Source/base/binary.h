@@ -14,7 +14,20 @@ namespace fff
 {
 bool filesHaveSameContent(const AbstractPath& filePath1, //throw FileError
                           const AbstractPath& filePath2,
-                          const zen::IOCallback& notifyUnbufferedIO); //may be nullptr
+                          const zen::IOCallback& notifyUnbufferedIO, //may be nullptr
+                          uint64_t* contentDigest = nullptr); //optional: set to getFileContentDigest() if files are equal
+
+//fail-fast check before filesHaveSameContent(): compare a small sample at the beginning and end of both files
+//returns false if files certainly differ; no value if sampling is not supported (non-native paths) or file size changed
+//fileSize <= 2 * FILE_SAMPLE_SIZE: samples are the full content => result is final
+const size_t FILE_SAMPLE_SIZE = 16 * 1024;
+std::optional<bool> fileSamplesMatch(const AbstractPath& filePath1, const AbstractPath& filePath2, uint64_t fileSize); //throw FileError
+
+//XXH64 of the file content: same as AFS::FileCopyResult::contentDigest
+uint64_t getFileContentDigest(const AbstractPath& filePath, const zen::IOCallback& notifyUnbufferedIO); //throw FileError; notifyUnbufferedIO may be nullptr
+
+//XXH64 of the first "bytesMax" bytes: cheap pre-check before getFileContentDigest()
+uint64_t getFileHeadDigest(const AbstractPath& filePath, size_t bytesMax, const zen::IOCallback& notifyUnbufferedIO); //throw FileError; notifyUnbufferedIO may be nullptr
 }
 
 #endif //BINARY_H_3941281398513241134
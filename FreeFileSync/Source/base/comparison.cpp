@@ -13,6 +13,8 @@
 #include "db_file.h"
 #include "binary.h"
 #include "cmp_filetime.h"
+#include "hash_cache.h"
+#include "scan_snapshot.h"
 #include "status_handler_impl.h"
 #include "../fs/concrete.h"
 
@@ -131,40 +133,66 @@ ResolvedBaseFolders initializeBaseFolders(const std::vector<FolderPairCfg>& fpCf
 
 //#############################################################################################################################
 
+using MergeThreadGroup = ThreadGroup<std::function<void()>>;
+
+
 class ComparisonBuffer
 {
 public:
-    ComparisonBuffer(const std::set<DirectoryKey>& foldersToRead,
+    //traverse folders and merge each folder pair of workLoad as soon as both sides are read: merging runs on worker threads
+    ComparisonBuffer(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad,
+                     const std::set<DirectoryKey>& foldersToRead,
                      const std::map<AbstractPath, size_t>& deviceParallelOps,
+                     size_t adaptiveParallelOpsMax,
+                     size_t fullRescanInterval,
                      int fileTimeTolerance,
                      ProcessCallback& callback);
 
-    //create comparison result table and fill category except for files existing on both sides: undefinedFiles and undefinedSymlinks are appended!
-    std::shared_ptr<BaseFolderPair> compareByTimeSize(const ResolvedFolderPair& fp, const FolderPairCfg& fpConfig) const;
-    std::shared_ptr<BaseFolderPair> compareBySize    (const ResolvedFolderPair& fp, const FolderPairCfg& fpConfig) const;
-    std::list<std::shared_ptr<BaseFolderPair>> compareByContent(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad) const;
+    //finish categorization of workLoad[pairIdx]: call once per folder pair!
+    std::shared_ptr<BaseFolderPair> compareByTimeSize(size_t pairIdx);
+    std::shared_ptr<BaseFolderPair> compareBySize    (size_t pairIdx);
+    std::list<std::shared_ptr<BaseFolderPair>> compareByContent(const std::vector<size_t>& pairIdxs);
 
 private:
     ComparisonBuffer           (const ComparisonBuffer&) = delete;
     ComparisonBuffer& operator=(const ComparisonBuffer&) = delete;
 
-    std::shared_ptr<BaseFolderPair> performComparison(const ResolvedFolderPair& fp,
-                                                      const FolderPairCfg& fpCfg,
-                                                      std::vector<FilePair*>& undefinedFiles,
-                                                      std::vector<SymlinkPair*>& undefinedSymlinks) const;
+    struct MergedFolderPair
+    {
+        std::shared_ptr<BaseFolderPair> output;
+        std::vector<FilePair*> undefinedFiles;       //existing on both sides:
+        std::vector<SymlinkPair*> undefinedSymlinks; //category yet to be determined
+    };
+
+    //create comparison result table and fill category except for files existing on both sides
+    //consumeLeft/Right: folder buffer is not needed by other folder pairs => release FolderContainer nodes while merging
+    //thread-safe: no callbacks, directoryBuffer_ is not accessed
+    MergedFolderPair performComparison(const ResolvedFolderPair& fp, const FolderPairCfg& fpCfg,
+                                       DirectoryValue* bufValueLeft, DirectoryValue* bufValueRight, //nullptr if folder not existing
+                                       bool consumeLeft, bool consumeRight,
+                                       MergeThreadGroup* mergeThreads, size_t mergeThreadCount) const; //large folder pairs: merge subtrees in parallel
 
-    std::map<DirectoryKey, DirectoryValue> directoryBuffer_; //contains only *existing* directories
+    void categorizeByTimeSize(const MergedFolderPair& mfp, const FolderPairCfg& fpCfg) const; //thread-safe
+
+    MergedFolderPair takeMergedPair(size_t pairIdx);
+
+    const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad_;
+    std::map<DirectoryKey, DirectoryValue> directoryBuffer_; //contains only *existing* directories; erased after last folder pair was merged
+    std::vector<std::optional<MergedFolderPair>> mergedPairs_; //same index as workLoad_
     const int fileTimeTolerance_;
     ProcessCallback& cb_;
-    const std::map<AbstractPath, size_t> deviceParallelOps_;
+    std::map<AbstractPath, size_t> deviceParallelOps_;
 };
 
 
-ComparisonBuffer::ComparisonBuffer(const std::set<DirectoryKey>& foldersToRead,
+ComparisonBuffer::ComparisonBuffer(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad,
+                                   const std::set<DirectoryKey>& foldersToRead,
                                    const std::map<AbstractPath, size_t>& deviceParallelOps,
+                                   size_t adaptiveParallelOpsMax,
+                                   size_t fullRescanInterval,
                                    int fileTimeTolerance,
                                    ProcessCallback& callback) :
-    fileTimeTolerance_(fileTimeTolerance), cb_(callback), deviceParallelOps_(deviceParallelOps)
+    workLoad_(workLoad), mergedPairs_(workLoad.size()), fileTimeTolerance_(fileTimeTolerance), cb_(callback), deviceParallelOps_(deviceParallelOps)
 {
     auto onError = [&](const std::wstring& msg, size_t retryNumber)
     {
@@ -180,6 +208,156 @@ ComparisonBuffer::ComparisonBuffer(const std::set<DirectoryKey>& foldersToRead,
         return AFS::TraverserCallback::ON_ERROR_CONTINUE;
     };
 
+    //pipeline scanning and merging: merge CPU time overlaps with remaining scan I/O, and each folder buffer is
+    //released right after its last folder pair was merged => peak memory no longer holds all FolderContainer trees *and* all BaseFolderPairs
+    auto getFolderKeys = [&](const std::pair<ResolvedFolderPair, FolderPairCfg>& w) //existing folders only
+    {
+        std::vector<DirectoryKey> folderKeys;
+        for (const AbstractPath& folderPath : { w.first.folderPathLeft, w.first.folderPathRight })
+        {
+            DirectoryKey folderKey{ folderPath, w.second.filter.nameFilter, w.second.handleSymlinks };
+            if (foldersToRead.find(folderKey) != foldersToRead.end())
+                folderKeys.push_back(std::move(folderKey));
+        }
+        return folderKeys;
+    };
+
+    std::map<DirectoryKey, size_t> unmergedUses; //number of folder pair sides yet to be merged
+    for (const auto& w : workLoad)
+        for (const DirectoryKey& folderKey : getFolderKeys(w))
+            ++unmergedUses[folderKey];
+
+    std::set<DirectoryKey> foldersRead;
+
+    //merge (+ strip excluded folders, time/size categorization) runs on worker threads, while this thread keeps serving the scan and its callbacks
+    struct MergeTask
+    {
+        size_t pairIdx;
+        std::set<DirectoryKey> folderKeys;
+        std::future<MergedFolderPair> result;
+        ObjectMgr<FileSystemObject>::DeferredRegistration registration; //ObjectMgr is not thread-safe
+    };
+    std::list<MergeTask> mergeTasks; //in flight
+
+    //one thread group for all merging, i.e. folder pairs *and* their subtrees (see MergeSides): merging is CPU-bound,
+    //but follow the user's parallelism settings: default of 1 parallel op per device => one merge thread (+ this thread)
+    size_t mergeThreadCount = 1;
+    for (const DirectoryKey& folderKey : foldersToRead)
+        mergeThreadCount = std::max(mergeThreadCount, getDeviceParallelOps(deviceParallelOps, folderKey.folderPath));
+    mergeThreadCount = std::min<size_t>(mergeThreadCount, std::max(std::thread::hardware_concurrency(), 1U));
+
+    MergeThreadGroup mergeThreads(mergeThreadCount, "Merge Folder Pairs"); //manage life time: enclose by mergeTasks!
+    std::vector<bool> mergeStarted(workLoad.size());
+
+    auto isMerging = [&](const DirectoryKey& folderKey)
+    {
+        return std::any_of(mergeTasks.begin(), mergeTasks.end(), [&](const MergeTask& mt) { return mt.folderKeys.find(folderKey) != mt.folderKeys.end(); });
+    };
+
+    auto collectMergeResults = [&](bool waitForAll)
+    {
+        for (auto it = mergeTasks.begin(); it != mergeTasks.end();)
+            if (waitForAll || it->result.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                mergedPairs_[it->pairIdx] = it->result.get(); //throw std::bad_alloc (from worker thread)
+                it->registration.commit();
+
+                const std::set<DirectoryKey> folderKeys = std::move(it->folderKeys);
+                it = mergeTasks.erase(it);
+
+                for (const DirectoryKey& folderKey : folderKeys)
+                    if (unmergedUses[folderKey] == 0 && !isMerging(folderKey))
+                        directoryBuffer_.erase(folderKey);
+            }
+            else
+                ++it;
+    };
+
+    auto mergeReadyPairs = [&] //throw X
+    {
+        collectMergeResults(false /*waitForAll*/);
+
+        for (size_t pairIdx = 0; pairIdx < workLoad.size(); ++pairIdx)
+            if (!mergeStarted[pairIdx])
+            {
+                const std::vector<DirectoryKey>& folderKeys = getFolderKeys(workLoad[pairIdx]);
+                if (std::all_of(folderKeys.begin(), folderKeys.end(), [&](const DirectoryKey& folderKey) { return foldersRead.find(folderKey) != foldersRead.end(); }))
+                {
+                    callback.reportStatus(_("Generating file list...")); //throw X
+                    callback.forceUiRefresh(); //throw X
+
+                    mergeStarted[pairIdx] = true;
+                    for (const DirectoryKey& folderKey : folderKeys)
+                        --unmergedUses[folderKey];
+
+                    const ResolvedFolderPair& fp    = workLoad[pairIdx].first;
+                    const FolderPairCfg&      fpCfg = workLoad[pairIdx].second;
+
+                    auto getDirValue = [&](const AbstractPath& folderPath) -> DirectoryValue*
+                    {
+                        auto it = directoryBuffer_.find({ folderPath, fpCfg.filter.nameFilter, fpCfg.handleSymlinks });
+                        return it != directoryBuffer_.end() ? &it->second : nullptr;
+                    };
+                    //release while merging only if no other merge is reading the same folder buffer
+                    auto isLastUse = [&](const AbstractPath& folderPath)
+                    {
+                        const DirectoryKey folderKey{ folderPath, fpCfg.filter.nameFilter, fpCfg.handleSymlinks };
+                        auto it = unmergedUses.find(folderKey);
+                        return it != unmergedUses.end() && it->second == 0 && !isMerging(folderKey);
+                    };
+                    DirectoryValue* bufValueLeft  = getDirValue(fp.folderPathLeft);
+                    DirectoryValue* bufValueRight = getDirValue(fp.folderPathRight);
+                    const bool consumeLeft  = isLastUse(fp.folderPathLeft);
+                    const bool consumeRight = isLastUse(fp.folderPathRight);
+
+                    auto promiseMerged = std::make_shared<std::promise<MergedFolderPair>>();
+                    MergeTask& mt = mergeTasks.emplace_back();
+                    mt.pairIdx    = pairIdx;
+                    mt.folderKeys.insert(folderKeys.begin(), folderKeys.end());
+                    mt.result     = promiseMerged->get_future();
+
+                    mergeThreads.run([this, &fp, &fpCfg, bufValueLeft, bufValueRight, consumeLeft, consumeRight, promiseMerged, &registration = mt.registration, &mergeThreads, mergeThreadCount]
+                    {
+                        try
+                        {
+                            registration.collect([&]
+                            {
+                                MergedFolderPair mfp = performComparison(fp, fpCfg, bufValueLeft, bufValueRight, consumeLeft, consumeRight, &mergeThreads, mergeThreadCount);
+
+                                if (fpCfg.compareVar == CompareVariant::TIME_SIZE)
+                                    categorizeByTimeSize(mfp, fpCfg);
+
+                                promiseMerged->set_value(std::move(mfp));
+                            });
+                        }
+                        catch (...) { promiseMerged->set_exception(std::current_exception()); } //e.g. std::bad_alloc
+                    });
+                }
+            }
+    };
+
+    //incremental traversal: skip reading folders that are unchanged since the previous run (native only: see AFS::FolderListing)
+    std::map<AbstractPath, FolderListings> prevListings;
+    std::map<AbstractPath, ScanSnapshot> scanSnapshots; //of this run
+    if (fullRescanInterval > 0)
+        for (const DirectoryKey& folderKey : foldersToRead)
+            if (AFS::getNativeItemPath(folderKey.folderPath) && prevListings.find(folderKey.folderPath) == prevListings.end())
+            {
+                ScanSnapshot snapshot;
+                try
+                {
+                    snapshot = loadScanSnapshot(folderKey.folderPath, [&](const std::wstring& statusMsg) { callback.reportStatus(statusMsg); /*throw X*/ }); //throw FileError, X
+                }
+                catch (const FileError& e) //not an error in this context: full rescan
+                {
+                    callback.reportInfo(e.toString()); //throw X
+                }
+
+                const bool fullRescan = snapshot.folders.empty() || snapshot.incrementalRuns + 1 >= fullRescanInterval; //safety net: full rescan every N-th run
+                scanSnapshots[folderKey.folderPath].incrementalRuns = fullRescan ? 0 : snapshot.incrementalRuns + 1;
+                prevListings [folderKey.folderPath] = fullRescan ? FolderListings() : std::move(snapshot.folders);
+            }
+
     const std::wstring textScanning = _("Scanning:") + L" ";
     int itemsReported = 0;
 
@@ -189,15 +367,52 @@ ComparisonBuffer::ComparisonBuffer(const std::set<DirectoryKey>& foldersToRead,
         itemsReported = itemsTotal;
 
         callback.reportStatus(textScanning + statusLine); //throw X
+
+        collectMergeResults(false /*waitForAll*/); //release folder buffers early
+    };
+
+    auto onFolderRead = [&](const DirectoryKey& folderKey)
+    {
+        if (auto it = scanSnapshots.find(folderKey.folderPath); it != scanSnapshots.end())
+            it->second.folders.merge(directoryBuffer_.find(folderKey)->second.folderListings); //same folder path with different filters: listings are equivalent
+
+        foldersRead.insert(folderKey);
+        mergeReadyPairs(); //throw X
     };
 
-    parallelDeviceTraversal(foldersToRead, //in
-                            directoryBuffer_, //out
-                            deviceParallelOps,
-                            onError, onStatusUpdate, //throw X
-                            UI_UPDATE_INTERVAL / 2); //every ~50 ms
+    const std::map<AbstractPath, size_t> adaptedParallelOps = parallelDeviceTraversal(foldersToRead, //in
+                                                                                      directoryBuffer_, //out
+                                                                                      prevListings,
+                                                                                      deviceParallelOps,
+                                                                                      adaptiveParallelOpsMax,
+                                                                                      onError, onStatusUpdate, onFolderRead, //throw X
+                                                                                      UI_UPDATE_INTERVAL / 2); //every ~50 ms
 
     callback.reportInfo(_("Comparison finished:") + L" " + _P("1 item found", "%x items found", itemsReported)); //throw X
+
+    mergeReadyPairs(); //throw X; remaining: folder pairs without existing folders
+    collectMergeResults(true /*waitForAll*/); //throw std::bad_alloc
+
+    prevListings.clear(); //reduce peak memory
+
+    for (const auto& [folderPath, snapshot] : scanSnapshots)
+        try
+        {
+            saveScanSnapshot(folderPath, snapshot, [&](const std::wstring& statusMsg) { callback.reportStatus(statusMsg); /*throw X*/ }); //throw FileError, X
+        }
+        catch (const FileError& e) //not an error in this context: full rescan next time
+        {
+            callback.reportInfo(e.toString()); //throw X
+        }
+    assert(directoryBuffer_.empty() && std::all_of(mergedPairs_.begin(), mergedPairs_.end(), [](const auto& mp) { return static_cast<bool>(mp); }));
+
+    if (!adaptedParallelOps.empty())
+    {
+        callback.reportInfo(formatAdaptedParallelOps(adaptedParallelOps)); //throw X
+
+        for (const auto& [rootPath, parallelOps] : adaptedParallelOps) //=> also use for binary comparison
+            setDeviceParallelOps(deviceParallelOps_, rootPath, parallelOps);
+    }
 }
 
 
@@ -287,12 +502,16 @@ void categorizeSymlinkByTime(SymlinkPair& symlink)
 }
 
 
-std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareByTimeSize(const ResolvedFolderPair& fp, const FolderPairCfg& fpConfig) const
+std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareByTimeSize(size_t pairIdx)
+{
+    return takeMergedPair(pairIdx).output; //categorized already while merging: see categorizeByTimeSize()
+}
+
+
+void ComparisonBuffer::categorizeByTimeSize(const MergedFolderPair& mfp, const FolderPairCfg& fpConfig) const
 {
-    //do basis scan and retrieve files existing on both sides as "compareCandidates"
-    std::vector<FilePair*> uncategorizedFiles;
-    std::vector<SymlinkPair*> uncategorizedLinks;
-    std::shared_ptr<BaseFolderPair> output = performComparison(fp, fpConfig, uncategorizedFiles, uncategorizedLinks);
+    //result of basis scan: files existing on both sides as "compareCandidates"
+    const auto& [output, uncategorizedFiles, uncategorizedLinks] = mfp;
 
     //finish symlink categorization
     for (SymlinkPair* symlink : uncategorizedLinks)
@@ -337,7 +556,6 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareByTimeSize(const Resolv
                 break;
         }
     }
-    return output;
 }
 
 
@@ -383,12 +601,10 @@ void categorizeSymlinkByContent(SymlinkPair& symlink, ProcessCallback& callback)
 }
 
 
-std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareBySize(const ResolvedFolderPair& fp, const FolderPairCfg& fpConfig) const
+std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareBySize(size_t pairIdx)
 {
-    //do basis scan and retrieve files existing on both sides as "compareCandidates"
-    std::vector<FilePair*> uncategorizedFiles;
-    std::vector<SymlinkPair*> uncategorizedLinks;
-    std::shared_ptr<BaseFolderPair> output = performComparison(fp, fpConfig, uncategorizedFiles, uncategorizedLinks);
+    //result of basis scan: retrieve files existing on both sides as "compareCandidates"
+    auto [output, uncategorizedFiles, uncategorizedLinks] = takeMergedPair(pairIdx);
 
     //finish symlink categorization
     for (SymlinkPair* symlink : uncategorizedLinks)
@@ -424,14 +640,111 @@ namespace parallel
 inline
 bool filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, //throw FileError
                           const IOCallback& notifyUnbufferedIO, //may be nullptr
+                          uint64_t* contentDigest, //optional
                           std::mutex& singleThread)
-{ return parallelScope([=] { return filesHaveSameContent(filePath1, filePath2, notifyUnbufferedIO); /*throw FileError*/ }, singleThread); }
+{ return parallelScope([=] { return filesHaveSameContent(filePath1, filePath2, notifyUnbufferedIO, contentDigest); /*throw FileError*/ }, singleThread); }
+
+inline
+std::optional<bool> fileSamplesMatch(const AbstractPath& filePath1, const AbstractPath& filePath2, uint64_t fileSize, std::mutex& singleThread) //throw FileError
+{ return parallelScope([=] { return fileSamplesMatch(filePath1, filePath2, fileSize); /*throw FileError*/ }, singleThread); }
 }
 
 
 namespace
 {
-void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingContentOfFiles, AsyncCallback& acb, std::mutex& singleThread) //throw ThreadInterruption
+template <SelectedSide side> inline
+ContentHashKey getContentHashKey(const FilePair& file)
+{
+    return { file.getFileId<side>(), file.getFileSize<side>(), file.getLastWriteTime<side>() };
+}
+
+
+struct ContentHashCache
+{
+    ContentHashes hashes;
+    bool modified = false;
+    std::vector<const BaseFolderPair*> foldersLeft;  //folder pairs referencing this cache: all their files' hashes are kept
+    std::vector<const BaseFolderPair*> foldersRight; //
+};
+
+
+template <SelectedSide side>
+void keepContentHashes(const ContainerObject& hierObj, const ContentHashes& hashes, ContentHashes& hashesInUse)
+{
+    for (const FilePair& file : hierObj.refSubFiles())
+        if (!file.isEmpty<side>())
+            if (auto it = hashes.find(getContentHashKey<side>(file)); it != hashes.end())
+                hashesInUse.insert(*it);
+
+    for (const FolderPair& folder : hierObj.refSubFolders())
+        keepContentHashes<side>(folder, hashes, hashesInUse);
+}
+
+
+std::optional<uint64_t> getCachedHash(const ContentHashCache& cache, const ContentHashKey& key)
+{
+    if (!key.fileId.empty()) //no file id => no cache
+        if (auto it = cache.hashes.find(key); it != cache.hashes.end())
+            return it->second;
+    return {};
+}
+
+
+void setCategoryByContent(FilePair& file, bool haveSameContent)
+{
+    if (haveSameContent)
+    {
+        //Caveat:
+        //1. FILE_EQUAL may only be set if short names match in case: InSyncFolder's mapping tables use short name as a key! see db_file.cpp
+        //2. FILE_EQUAL is expected to mean identical file sizes! See InSyncFile
+        //3. harmonize with "bool stillInSync()" in algorithm.cpp, FilePair::setSyncedTo() in file_hierarchy.h
+        if (file.getItemName<LEFT_SIDE>() != file.getItemName<RIGHT_SIDE>())
+            file.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(file));
+#if 0 //don't synchronize modtime only see FolderPairSyncer::synchronizeFileInt(), SO_COPY_METADATA_TO_*
+        else if (!sameFileTime(file.getLastWriteTime<LEFT_SIDE>(),
+                               file.getLastWriteTime<RIGHT_SIDE>(), file.base().getFileTimeTolerance(), file.base().getIgnoredTimeShift()))
+            file.setCategoryDiffMetadata(getDescrDiffMetaDate(file));
+#endif
+        else
+            file.setCategory<FILE_EQUAL>();
+    }
+    else
+        file.setCategory<FILE_DIFFERENT_CONTENT>();
+}
+
+
+//fail-fast pass before categorizeFileByContent(): return false if file content is already known (different, or small files read completely)
+bool sampleFileContent(FilePair& file, const ContentHashCache* hashesL /*optional*/, const ContentHashCache* hashesR /*optional*/, //throw ThreadInterruption
+                       AsyncCallback& acb, std::mutex& singleThread)
+{
+    //CompareVariant::CONTENT_CACHED: don't spend I/O if the cached hashes can be used instead
+    if (hashesL && hashesR)
+        if (getCachedHash(*hashesL, getContentHashKey<LEFT_SIDE >(file)) &&
+            getCachedHash(*hashesR, getContentHashKey<RIGHT_SIDE>(file)))
+            return true;
+
+    std::optional<bool> samplesMatch;
+    try
+    {
+        samplesMatch = parallel::fileSamplesMatch(file.getAbstractPath<LEFT_SIDE >(),
+                                                  file.getAbstractPath<RIGHT_SIDE>(), file.getFileSize<LEFT_SIDE>(), singleThread); //throw FileError
+    }
+    catch (FileError&) {} //not an error in this context: categorizeFileByContent() will report
+    interruptionPoint(); //throw ThreadInterruption
+
+    if (!samplesMatch || (*samplesMatch && file.getFileSize<LEFT_SIDE>() > 2 * FILE_SAMPLE_SIZE)) //small files: samples are the full content
+        return true;
+
+    AsyncItemStatReporter statReporter(1, file.getFileSize<LEFT_SIDE>(), acb); //finish item: correct total bytes of this phase
+    setCategoryByContent(file, *samplesMatch);
+    statReporter.reportDelta(1, 0);
+    return false;
+}
+
+
+//CompareVariant::CONTENT_CACHED: hash caches are accessed with singleThread lock held
+void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingContentOfFiles, //throw ThreadInterruption
+                             ContentHashCache* hashesL /*optional*/, ContentHashCache* hashesR /*optional*/, AsyncCallback& acb, std::mutex& singleThread)
 {
     acb.reportStatus(replaceCpy(txtComparingContentOfFiles, L"%x", fmtPath(file.getPairRelativePath()))); //throw ThreadInterruption
 
@@ -447,39 +760,57 @@ void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingCon
             interruptionPoint(); //throw ThreadInterruption
         };
 
-        haveSameContent = parallel::filesHaveSameContent(file.getAbstractPath<LEFT_SIDE >(),
-                                                         file.getAbstractPath<RIGHT_SIDE>(), notifyUnbufferedIO, singleThread); //throw FileError
+        if (hashesL && hashesR)
+        {
+            const ContentHashKey keyL = getContentHashKey<LEFT_SIDE >(file);
+            const ContentHashKey keyR = getContentHashKey<RIGHT_SIDE>(file);
+
+            const std::optional<uint64_t> hashL = getCachedHash(*hashesL, keyL);
+            const std::optional<uint64_t> hashR = getCachedHash(*hashesR, keyR);
+
+            if (hashL && hashR) //only trust digests of a previous byte-by-byte comparison
+                haveSameContent = *hashL == *hashR;
+            else
+            {
+                uint64_t contentDigest = 0;
+                haveSameContent = parallel::filesHaveSameContent(file.getAbstractPath<LEFT_SIDE >(),
+                                                                 file.getAbstractPath<RIGHT_SIDE>(), notifyUnbufferedIO, &contentDigest, singleThread); //throw FileError
+                if (haveSameContent)
+                {
+                    const time_t hashTime = std::time(nullptr);
+
+                    auto updateCachedHash = [&](ContentHashCache& cache, const ContentHashKey& key)
+                    {
+                        //racy: file modified within the file system's time stamp granularity => a later modification might leave the key unchanged
+                        //=> same rule as getChangeStamp() in native.cpp
+                        if (!key.fileId.empty() && hashTime - key.modTime >= 2)
+                            if (auto [it, inserted] = cache.hashes.emplace(key, contentDigest);
+                                inserted || it->second != contentDigest)
+                            {
+                                it->second = contentDigest;
+                                cache.modified = true;
+                            }
+                    };
+                    updateCachedHash(*hashesL, keyL);
+                    updateCachedHash(*hashesR, keyR);
+                }
+            }
+        }
+        else
+            haveSameContent = parallel::filesHaveSameContent(file.getAbstractPath<LEFT_SIDE >(),
+                                                             file.getAbstractPath<RIGHT_SIDE>(), notifyUnbufferedIO, nullptr, singleThread); //throw FileError
         statReporter.reportDelta(1, 0);
     }, acb); //throw ThreadInterruption
 
     if (!errMsg.empty())
         file.setCategoryConflict(copyStringTo<Zstringw>(errMsg));
     else
-    {
-        if (haveSameContent)
-        {
-            //Caveat:
-            //1. FILE_EQUAL may only be set if short names match in case: InSyncFolder's mapping tables use short name as a key! see db_file.cpp
-            //2. FILE_EQUAL is expected to mean identical file sizes! See InSyncFile
-            //3. harmonize with "bool stillInSync()" in algorithm.cpp, FilePair::setSyncedTo() in file_hierarchy.h
-            if (file.getItemName<LEFT_SIDE>() != file.getItemName<RIGHT_SIDE>())
-                file.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(file));
-#if 0 //don't synchronize modtime only see FolderPairSyncer::synchronizeFileInt(), SO_COPY_METADATA_TO_*
-            else if (!sameFileTime(file.getLastWriteTime<LEFT_SIDE>(),
-                                   file.getLastWriteTime<RIGHT_SIDE>(), file.base().getFileTimeTolerance(), file.base().getIgnoredTimeShift()))
-                file.setCategoryDiffMetadata(getDescrDiffMetaDate(file));
-#endif
-            else
-                file.setCategory<FILE_EQUAL>();
-        }
-        else
-            file.setCategory<FILE_DIFFERENT_CONTENT>();
-    }
+        setCategoryByContent(file, haveSameContent);
 }
 }
 
 
-std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad) const
+std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(const std::vector<size_t>& pairIdxs)
 {
     struct ParallelOps
     {
@@ -493,11 +824,33 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
     {
         ParallelOps& parallelOpsL; //
         ParallelOps& parallelOpsR; //consider aliasing!
+        ContentHashCache* hashesL; //CompareVariant::CONTENT_CACHED only
+        ContentHashCache* hashesR; //consider aliasing!
         RingBuffer<FilePair*> filesToCompareBytewise;
+        std::vector<FilePair*> filesSamplesMatching;
     };
     std::vector<BinaryWorkload> fpWorkload;
 
-    auto addToBinaryWorkload = [&](const AbstractPath& basePathL, const AbstractPath& basePathR, RingBuffer<FilePair*>&& filesToCompareBytewise)
+    //CompareVariant::CONTENT_CACHED: one cache per base folder, shared between folder pairs
+    std::map<AbstractPath, ContentHashCache> hashCaches;
+
+    auto getHashCache = [&](const AbstractPath& basePath) -> ContentHashCache&
+    {
+        auto [it, inserted] = hashCaches.try_emplace(basePath);
+        if (inserted)
+            try
+            {
+                it->second.hashes = loadContentHashes(basePath, [&](const std::wstring& statusMsg) { cb_.reportStatus(statusMsg); /*throw X*/ }); //throw FileError, X
+            }
+            catch (const FileError& e) //not an error in this context: start with an empty cache
+            {
+                cb_.reportInfo(e.toString()); //throw X
+            }
+        return it->second;
+    };
+
+    auto addToBinaryWorkload = [&](const AbstractPath& basePathL, const AbstractPath& basePathR, ContentHashCache* hashesL, ContentHashCache* hashesR,
+                                   RingBuffer<FilePair*>&& filesToCompareBytewise)
     {
         const AbstractPath rootPathL = AFS::getRootPath(basePathL);
         const AbstractPath rootPathR = AFS::getRootPath(basePathR);
@@ -512,7 +865,7 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
         posL.effectiveMax = std::max(posL.effectiveMax, parallelOpsFp);
         posR.effectiveMax = std::max(posR.effectiveMax, parallelOpsFp);
 
-        fpWorkload.push_back({ posL, posR, std::move(filesToCompareBytewise) });
+        fpWorkload.push_back({ posL, posR, hashesL, hashesR, std::move(filesToCompareBytewise) });
     };
 
     //PERF_START;
@@ -520,12 +873,13 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
 
     const Zstringw txtConflictSkippedBinaryComparison = getConflictSkippedBinaryComparison(); //avoid premature pess.: save memory via ref-counted string
 
-    for (const auto& w : workLoad)
+    for (const size_t pairIdx : pairIdxs)
     {
-        std::vector<FilePair*> undefinedFiles;
-        std::vector<SymlinkPair*> uncategorizedLinks;
-        //run basis scan and retrieve candidates for binary comparison (files existing on both sides)
-        output.push_back(performComparison(w.first, w.second, undefinedFiles, uncategorizedLinks));
+        const FolderPairCfg& fpCfg = workLoad_[pairIdx].second;
+
+        //result of basis scan: retrieve candidates for binary comparison (files existing on both sides)
+        auto [fpOutput, undefinedFiles, uncategorizedLinks] = takeMergedPair(pairIdx);
+        output.push_back(fpOutput);
 
         RingBuffer<FilePair*> filesToCompareBytewise;
         //content comparison of file content happens AFTER finding corresponding files and AFTER filtering
@@ -543,9 +897,21 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
                 else
                     filesToCompareBytewise.push_back(file);
             }
+        const BaseFolderPair& baseFolder = *output.back();
+        ContentHashCache* hashesL = nullptr;
+        ContentHashCache* hashesR = nullptr;
+        if (fpCfg.compareVar == CompareVariant::CONTENT_CACHED &&
+            baseFolder.isAvailable<LEFT_SIDE>() && baseFolder.isAvailable<RIGHT_SIDE>())
+        {
+            hashesL = &getHashCache(baseFolder.getAbstractPath<LEFT_SIDE >()); //throw X
+            hashesR = &getHashCache(baseFolder.getAbstractPath<RIGHT_SIDE>()); //
+            hashesL->foldersLeft .push_back(&baseFolder);
+            hashesR->foldersRight.push_back(&baseFolder);
+        }
+
         if (!filesToCompareBytewise.empty())
-            addToBinaryWorkload(output.back()->getAbstractPath<LEFT_SIDE >(),
-                                output.back()->getAbstractPath<RIGHT_SIDE>(), std::move(filesToCompareBytewise));
+            addToBinaryWorkload(baseFolder.getAbstractPath<LEFT_SIDE >(),
+                                baseFolder.getAbstractPath<RIGHT_SIDE>(), hashesL, hashesR, std::move(filesToCompareBytewise));
 
         //finish symlink categorization
         for (SymlinkPair* symlink : uncategorizedLinks)
@@ -568,66 +934,114 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
 
         //PERF_START;
 
-        std::mutex singleThread; //only a single worker thread may run at a time, except for parallel file I/O
-
-        AsyncCallback acb;                       //
-        std::function<void()> scheduleMoreTasks; //manage life time: enclose ThreadGroup!
-        const std::wstring txtComparingContentOfFiles = _("Comparing content of files %x"); //
+        //process all filesToCompareBytewise, respecting the parallel operations supported per device
+        auto processWorkload = [&](const std::function<void(FilePair& file, BinaryWorkload& bwl, AsyncCallback& acb, std::mutex& singleThread)>& processFile) //throw X
+        {
+            std::mutex singleThread; //only a single worker thread may run at a time, except for parallel file I/O
 
-        ThreadGroup<std::function<void()>> tg(std::numeric_limits<size_t>::max(), "Binary Comparison");
+            AsyncCallback acb;                       //
+            std::function<void()> scheduleMoreTasks; //manage life time: enclose ThreadGroup!
 
-        scheduleMoreTasks = [&]
-        {
-            bool wereDone = true;
+            ThreadGroup<std::function<void()>> tg(std::numeric_limits<size_t>::max(), "Binary Comparison");
 
-            for (size_t j = 0; j < fpWorkload.size(); ++j)
+            scheduleMoreTasks = [&]
             {
-                BinaryWorkload& bwl = fpWorkload[j];
+                bool wereDone = true;
 
-                ParallelOps& posL = bwl.parallelOpsL;
-                ParallelOps& posR = bwl.parallelOpsR;
+                for (size_t j = 0; j < fpWorkload.size(); ++j)
+                {
+                    BinaryWorkload& bwl = fpWorkload[j];
 
-                const size_t newTaskCount = numeric::min<size_t>(posL.effectiveMax - posL.current,
-                                                                 posR.effectiveMax - posR.current,
-                                                                 bwl.filesToCompareBytewise.size());
-                if (&posL != &posR) posL.current += newTaskCount; //
-                /**/                posR.current += newTaskCount; //consider aliasing!
+                    ParallelOps& posL = bwl.parallelOpsL;
+                    ParallelOps& posR = bwl.parallelOpsR;
 
-                for (size_t i = 0; i < newTaskCount; ++i)
-                {
-                    tg.run([&, statusPrio = j, &file = *bwl.filesToCompareBytewise.front()]
+                    const size_t newTaskCount = numeric::min<size_t>(posL.effectiveMax - posL.current,
+                                                                     posR.effectiveMax - posR.current,
+                                                                     bwl.filesToCompareBytewise.size());
+                    if (&posL != &posR) posL.current += newTaskCount; //
+                    /**/                posR.current += newTaskCount; //consider aliasing!
+
+                    for (size_t i = 0; i < newTaskCount; ++i)
                     {
-                        acb.notifyTaskBegin(statusPrio); //prioritize status messages according to natural order of folder pairs
-                        ZEN_ON_SCOPE_EXIT(acb.notifyTaskEnd());
+                        tg.run([&, statusPrio = j, &file = *bwl.filesToCompareBytewise.front()]
+                        {
+                            acb.notifyTaskBegin(statusPrio); //prioritize status messages according to natural order of folder pairs
+                            ZEN_ON_SCOPE_EXIT(acb.notifyTaskEnd());
 
-                        std::lock_guard<std::mutex> dummy(singleThread); //protect ALL variable accesses unless explicitly not needed ("parallel" scope)!
-                        //---------------------------------------------------------------------------------------------------
-                        ZEN_ON_SCOPE_SUCCESS(if (&posL != &posR) --posL.current;
-                                             /**/                --posR.current;
-                                             scheduleMoreTasks(););
+                            std::lock_guard<std::mutex> dummy(singleThread); //protect ALL variable accesses unless explicitly not needed ("parallel" scope)!
+                            //---------------------------------------------------------------------------------------------------
+                            ZEN_ON_SCOPE_SUCCESS(if (&posL != &posR) --posL.current;
+                                                 /**/                --posR.current;
+                                                 scheduleMoreTasks(););
 
-                        categorizeFileByContent(file, txtComparingContentOfFiles, acb, singleThread); //throw ThreadInterruption
-                    });
+                            processFile(file, bwl, acb, singleThread); //throw ThreadInterruption
+                        });
 
-                    bwl.filesToCompareBytewise.pop_front();
-                }
+                        bwl.filesToCompareBytewise.pop_front();
+                    }
+
+                    assert(0 <= posL.current && posL.current <= posL.effectiveMax);
+                    assert(0 <= posR.current && posR.current <= posR.effectiveMax);
 
-                assert(0 <= posL.current && posL.current <= posL.effectiveMax);
-                assert(0 <= posR.current && posR.current <= posR.effectiveMax);
+                    if (posL.current != 0 || posR.current != 0 || !bwl.filesToCompareBytewise.empty())
+                        wereDone = false;
+                }
+                if (wereDone)
+                    acb.notifyAllDone();
+            };
 
-                if (posL.current != 0 || posR.current != 0 || !bwl.filesToCompareBytewise.empty())
-                    wereDone = false;
+            {
+                std::lock_guard<std::mutex> dummy(singleThread); //[!] potential race with worker threads!
+                scheduleMoreTasks(); //set initial load
             }
-            if (wereDone)
-                acb.notifyAllDone();
+
+            acb.waitUntilDone(UI_UPDATE_INTERVAL / 2 /*every ~50 ms*/, cb_); //throw X
         };
 
+        //1. fail-fast: compare small samples at the beginning and end of all files first
+        cb_.reportStatus(_("Comparing content...")); //throw X
+
+        processWorkload([](FilePair& file, BinaryWorkload& bwl, AsyncCallback& acb, std::mutex& singleThread)
+        {
+            if (sampleFileContent(file, bwl.hashesL, bwl.hashesR, acb, singleThread)) //throw ThreadInterruption
+                bwl.filesSamplesMatching.push_back(&file);
+        });
+
+        //2. compare remaining files in full: largest first to keep all parallel operations busy until the end
+        for (BinaryWorkload& bwl : fpWorkload)
         {
-            std::lock_guard<std::mutex> dummy(singleThread); //[!] potential race with worker threads!
-            scheduleMoreTasks(); //set initial load
+            std::stable_sort(bwl.filesSamplesMatching.begin(), bwl.filesSamplesMatching.end(), [](const FilePair* lhs, const FilePair* rhs)
+            { return lhs->getFileSize<LEFT_SIDE>() > rhs->getFileSize<LEFT_SIDE>(); });
+
+            for (FilePair* file : bwl.filesSamplesMatching)
+                bwl.filesToCompareBytewise.push_back(file);
+            bwl.filesSamplesMatching.clear();
         }
 
-        acb.waitUntilDone(UI_UPDATE_INTERVAL / 2 /*every ~50 ms*/, cb_); //throw X
+        const std::wstring txtComparingContentOfFiles = _("Comparing content of files %x");
+
+        processWorkload([&](FilePair& file, BinaryWorkload& bwl, AsyncCallback& acb, std::mutex& singleThread)
+        {
+            categorizeFileByContent(file, txtComparingContentOfFiles, bwl.hashesL, bwl.hashesR, acb, singleThread); //throw ThreadInterruption
+        });
+    }
+
+    //update hash caches: keep only hashes of files that still exist
+    for (auto& [basePath, cache] : hashCaches)
+    {
+        ContentHashes hashesInUse;
+        for (const BaseFolderPair* baseFolder : cache.foldersLeft ) keepContentHashes<LEFT_SIDE >(*baseFolder, cache.hashes, hashesInUse);
+        for (const BaseFolderPair* baseFolder : cache.foldersRight) keepContentHashes<RIGHT_SIDE>(*baseFolder, cache.hashes, hashesInUse);
+
+        if (cache.modified || hashesInUse.size() != cache.hashes.size()) //don't touch the file if not needed
+            try
+            {
+                saveContentHashes(basePath, hashesInUse, [&](const std::wstring& statusMsg) { cb_.reportStatus(statusMsg); /*throw X*/ }); //throw FileError, X
+            }
+            catch (const FileError& e) //not an error in this context: hashes will be recalculated next time
+            {
+                cb_.reportInfo(e.toString()); //throw X
+            }
     }
 
     return output;
@@ -635,36 +1049,196 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
 
 //-----------------------------------------------------------------------------------------------
 
+//first level whose sub folders are enough to keep all threads busy; none if the tree is too small
+std::optional<size_t> getForkLevel(const FolderContainer& lhs, const FolderContainer& rhs, size_t folderCountMin)
+{
+    std::vector<const FolderContainer*> level{ &lhs, &rhs }; //lhs and rhs may alias: counted twice => doesn't matter
+
+    for (size_t i = 0; i < 4 && !level.empty(); ++i)
+    {
+        std::vector<const FolderContainer*> subLevel;
+        for (const FolderContainer* folderCont : level)
+            for (const auto& [folderName, attrAndCont] : folderCont->folders)
+                subLevel.push_back(attrAndCont.second.get());
+
+        if (subLevel.size() >= folderCountMin)
+            return i;
+        level.swap(subLevel);
+    }
+    return {};
+}
+
+
 class MergeSides
 {
 public:
     MergeSides(const std::map<Zstring, Zstringw, LessFilePath>& failedItemReads,
                std::vector<FilePair*>& undefinedFilesOut,
-               std::vector<SymlinkPair*>& undefinedSymlinksOut) :
+               std::vector<SymlinkPair*>& undefinedSymlinksOut,
+               bool consumeLeft, bool consumeRight) : //release FolderContainer nodes as soon as they are merged
         failedItemReads_(failedItemReads),
         undefinedFiles_(undefinedFilesOut),
-        undefinedSymlinks_(undefinedSymlinksOut) {}
+        undefinedSymlinks_(undefinedSymlinksOut),
+        consumeLeft_(consumeLeft),
+        consumeRight_(consumeRight) {}
 
-    void execute(const FolderContainer& lhs, const FolderContainer& rhs, ContainerObject& output)
+    //mergeThreads: shared by all folder pairs (may be busy merging other pairs); nullptr or threadCount == 1: serial merge
+    void execute(FolderContainer& lhs, FolderContainer& rhs, ContainerObject& output, MergeThreadGroup* mergeThreads, size_t threadCount) //throw std::bad_alloc
     {
         auto it = failedItemReads_.find(Zstring()); //empty path if read-error for whole base directory
+        const Zstringw* errorMsg = it != failedItemReads_.end() ? &it->second : nullptr;
 
-        mergeTwoSides(lhs, rhs,
-                      it != failedItemReads_.end() ? &it->second : nullptr,
-                      output);
+        if (mergeThreads && threadCount > 1)
+            forkLevel_ = getForkLevel(lhs, rhs, 4 * threadCount);
+
+        if (!forkLevel_)
+            return mergeTwoSides(lhs, rhs, errorMsg, output, 0 /*level*/);
+
+        //fork-join: merge upper levels on this thread and collect the subtrees below forkLevel_ => merge subtrees in parallel
+        std::vector<SubtreeTask> subtreeTasks;
+        subtreeTasks_ = &subtreeTasks;
+        mergeTwoSides(lhs, rhs, errorMsg, output, 0 /*level*/);
+        subtreeTasks_ = nullptr;
+
+        //helpers queued on the shared thread group may start only after this function returned => keep state alive via shared_ptr;
+        //the calling thread takes subtree tasks, too: no deadlock even if all threads are busy (possibly waiting here themselves)
+        struct SubtreeProgress
+        {
+            std::atomic<size_t> nextTask{ 0 };
+            size_t tasksDone = 0; //protected by lockDone
+            std::exception_ptr taskError; //
+            std::mutex lockDone;
+            std::condition_variable conditionDone;
+        };
+        const auto progress = std::make_shared<SubtreeProgress>();
+        const size_t taskCount = subtreeTasks.size();
+
+        auto processTasks = [this, progress, taskCount, tasks = subtreeTasks.data()] //tasks is not accessed after nextTask ran out
+        {
+            for (size_t i = 0; (i = progress->nextTask++) < taskCount;)
+            {
+                try
+                {
+                    mergeSubtree(tasks[i]); //throw std::bad_alloc
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> dummy(progress->lockDone);
+                    if (!progress->taskError)
+                        progress->taskError = std::current_exception();
+                }
+                {
+                    std::lock_guard<std::mutex> dummy(progress->lockDone);
+                    ++progress->tasksDone;
+                }
+                progress->conditionDone.notify_all();
+            }
+        };
+        for (size_t i = 1; i < std::min(threadCount, taskCount); ++i)
+            mergeThreads->run(processTasks);
+
+        processTasks();
+        {
+            std::unique_lock<std::mutex> dummy(progress->lockDone);
+            progress->conditionDone.wait(dummy, [&] { return progress->tasksDone == taskCount; });
+            if (progress->taskError)
+                std::rethrow_exception(progress->taskError); //throw std::bad_alloc (from worker thread)
+        }
+
+        //same result as a serial merge: FileSystemObject lists are ordered already, undefinedFiles/Symlinks need the subtree items inserted
+        auto insertSubtreeItems = [&](auto& items, auto taskItems, auto taskItemsPos)
+        {
+            std::remove_reference_t<decltype(items)> itemsAll;
+            size_t pos = 0;
+            for (const SubtreeTask& task : subtreeTasks)
+            {
+                itemsAll.insert(itemsAll.end(), items.begin() + pos, items.begin() + task.*taskItemsPos);
+                itemsAll.insert(itemsAll.end(), (task.*taskItems).begin(), (task.*taskItems).end());
+                pos = task.*taskItemsPos;
+            }
+            itemsAll.insert(itemsAll.end(), items.begin() + pos, items.end());
+            items.swap(itemsAll);
+        };
+        insertSubtreeItems(undefinedFiles_,    &SubtreeTask::undefinedFiles,    &SubtreeTask::undefinedFilesPos);
+        insertSubtreeItems(undefinedSymlinks_, &SubtreeTask::undefinedSymlinks, &SubtreeTask::undefinedSymlinksPos);
+
+        for (SubtreeTask& task : subtreeTasks)
+            task.registration.commit();
+
+        consumeMerged< LEFT_SIDE>(lhs); //upper levels were skipped while subtrees were pending
+        consumeMerged<RIGHT_SIDE>(rhs); //
     }
 
 private:
-    void mergeTwoSides(const FolderContainer& lhs, const FolderContainer& rhs, const Zstringw* errorMsg, ContainerObject& output);
+    struct SubtreeTask;
+    void mergeSubtree(SubtreeTask& task) const //thread-safe
+    {
+        MergeSides subtreeMerge(failedItemReads_, task.undefinedFiles, task.undefinedSymlinks, consumeLeft_, consumeRight_);
+
+        task.registration.collect([&] //ObjectMgr is not thread-safe
+        {
+            if (task.lhs && task.rhs)
+                subtreeMerge.mergeTwoSides(*task.lhs, *task.rhs, task.errorMsg, *task.output, *forkLevel_ + 1);
+            else if (task.lhs)
+                subtreeMerge.fillOneSide<LEFT_SIDE>(*task.lhs, task.errorMsg, *task.output, *forkLevel_ + 1);
+            else
+                subtreeMerge.fillOneSide<RIGHT_SIDE>(*task.rhs, task.errorMsg, *task.output, *forkLevel_ + 1);
+        });
+    }
+
+    void mergeTwoSides(FolderContainer& lhs, FolderContainer& rhs, const Zstringw* errorMsg, ContainerObject& output, size_t level);
 
     template <SelectedSide side>
-    void fillOneSide(const FolderContainer& folderCont, const Zstringw* errorMsg, ContainerObject& output);
+    void fillOneSide(FolderContainer& folderCont, const Zstringw* errorMsg, ContainerObject& output, size_t level);
+
+    template <SelectedSide side>
+    void consumeMerged(FolderContainer& folderCont) const
+    {
+        if (subtreeTasks_) //sub folders are still referenced by pending subtree tasks
+            return;
+
+        if (side == LEFT_SIDE ? consumeLeft_ : consumeRight_)
+        {
+            folderCont.files    = FolderContainer::FileList   (); //release memory, not just the items
+            folderCont.symlinks = FolderContainer::SymlinkList(); //
+            folderCont.folders  = FolderContainer::FolderList (); //child containers are already empty: merged bottom-up
+        }
+    }
+
+    //at forkLevel_: don't recurse into sub folder, but leave it to a subtree task
+    bool forkSubtree(FolderContainer* lhs, FolderContainer* rhs, const Zstringw* errorMsg, FolderPair& output, size_t level)
+    {
+        if (!subtreeTasks_ || level != *forkLevel_)
+            return false;
+
+        subtreeTasks_->push_back({ lhs, rhs, errorMsg, &output, undefinedFiles_.size(), undefinedSymlinks_.size() });
+        return true;
+    }
 
     const Zstringw* checkFailedRead(FileSystemObject& fsObj, const Zstringw* errorMsg);
 
+    struct SubtreeTask
+    {
+        FolderContainer* lhs; //nullptr if folder exists on right side only
+        FolderContainer* rhs; //nullptr if folder exists on left side only
+        const Zstringw* errorMsg;
+        FolderPair* output;
+
+        size_t undefinedFilesPos;    //insert position in the serial merge result
+        size_t undefinedSymlinksPos; //
+        std::vector<FilePair*>    undefinedFiles;
+        std::vector<SymlinkPair*> undefinedSymlinks;
+        ObjectMgr<FileSystemObject>::DeferredRegistration registration;
+    };
+
     const std::map<Zstring, Zstringw, LessFilePath>& failedItemReads_; //base-relative paths or empty if read-error for whole base directory
     std::vector<FilePair*>&   undefinedFiles_;
     std::vector<SymlinkPair*>& undefinedSymlinks_;
+    const bool consumeLeft_;
+    const bool consumeRight_;
+
+    std::optional<size_t> forkLevel_;
+    std::vector<SubtreeTask>* subtreeTasks_ = nullptr; //collect subtrees at forkLevel_ while merging the upper levels
 };
 
 
@@ -689,7 +1263,7 @@ const Zstringw* MergeSides::checkFailedRead(FileSystemObject& fsObj, const Zstri
 
 
 template <SelectedSide side>
-void MergeSides::fillOneSide(const FolderContainer& folderCont, const Zstringw* errorMsg, ContainerObject& output)
+void MergeSides::fillOneSide(FolderContainer& folderCont, const Zstringw* errorMsg, ContainerObject& output, size_t level)
 {
     for (const auto& file : folderCont.files)
     {
@@ -703,20 +1277,24 @@ void MergeSides::fillOneSide(const FolderContainer& folderCont, const Zstringw*
         checkFailedRead(newItem, errorMsg);
     }
 
-    for (const auto& dir : folderCont.folders)
+    for (auto& dir : folderCont.folders)
     {
         FolderPair& newFolder = output.addSubFolder<side>(dir.first, dir.second.first);
         const Zstringw* errorMsgNew = checkFailedRead(newFolder, errorMsg);
-        fillOneSide<side>(dir.second.second, errorMsgNew, newFolder); //recurse
+
+        if (!forkSubtree(side == LEFT_SIDE ? dir.second.second.get() : nullptr,
+                         side == LEFT_SIDE ? nullptr : dir.second.second.get(), errorMsgNew, newFolder, level))
+            fillOneSide<side>(*dir.second.second, errorMsgNew, newFolder, level + 1); //recurse
     }
+    consumeMerged<side>(folderCont);
 }
 
 
 //perf: 70% faster than traversing over left and right containers + more natural default sequence
 //- 2 x lessKey vs 1 x cmpFilePath() => no significant difference
 //- simplify loop by placing the eob check at the beginning => slightly slower
-template <class MapType, class ProcessLeftOnly, class ProcessRightOnly, class ProcessBoth> inline
-void linearMerge(const MapType& mapLeft, const MapType& mapRight, ProcessLeftOnly lo, ProcessRightOnly ro, ProcessBoth bo)
+template <class ListType, class ProcessLeftOnly, class ProcessRightOnly, class ProcessBoth> inline
+void linearMerge(ListType& mapLeft, ListType& mapRight, ProcessLeftOnly lo, ProcessRightOnly ro, ProcessBoth bo) //lists sorted by LessFilePath: see FolderContainer::freeze()
 {
     auto itL = mapLeft .begin();
     auto itR = mapRight.begin();
@@ -727,7 +1305,7 @@ void linearMerge(const MapType& mapLeft, const MapType& mapRight, ProcessLeftOnl
     if (itL == mapLeft .end()) return finishRight();
     if (itR == mapRight.end()) return finishLeft ();
 
-    const auto lessKey = typename MapType::key_compare();
+    const auto lessKey = LessFilePath();
 
     for (;;)
         if (lessKey(itL->first, itR->first))
@@ -753,7 +1331,7 @@ void linearMerge(const MapType& mapLeft, const MapType& mapRight, ProcessLeftOnl
 }
 
 
-void MergeSides::mergeTwoSides(const FolderContainer& lhs, const FolderContainer& rhs, const Zstringw* errorMsg, ContainerObject& output)
+void MergeSides::mergeTwoSides(FolderContainer& lhs, FolderContainer& rhs, const Zstringw* errorMsg, ContainerObject& output, size_t level)
 {
     using FileData = FolderContainer::FileList::value_type;
 
@@ -795,20 +1373,22 @@ void MergeSides::mergeTwoSides(const FolderContainer& lhs, const FolderContainer
     using FolderData = FolderContainer::FolderList::value_type;
 
     linearMerge(lhs.folders, rhs.folders,
-                [&](const FolderData& dirLeft) //left only
+                [&](FolderData& dirLeft) //left only
     {
         FolderPair& newFolder = output.addSubFolder<LEFT_SIDE>(dirLeft.first, dirLeft.second.first);
         const Zstringw* errorMsgNew = checkFailedRead(newFolder, errorMsg);
-        this->fillOneSide<LEFT_SIDE>(dirLeft.second.second, errorMsgNew, newFolder); //recurse
+        if (!forkSubtree(dirLeft.second.second.get(), nullptr, errorMsgNew, newFolder, level))
+            this->fillOneSide<LEFT_SIDE>(*dirLeft.second.second, errorMsgNew, newFolder, level + 1); //recurse
     },
-    [&](const FolderData& dirRight) //right only
+    [&](FolderData& dirRight) //right only
     {
         FolderPair& newFolder = output.addSubFolder<RIGHT_SIDE>(dirRight.first, dirRight.second.first);
         const Zstringw* errorMsgNew = checkFailedRead(newFolder, errorMsg);
-        this->fillOneSide<RIGHT_SIDE>(dirRight.second.second, errorMsgNew, newFolder); //recurse
+        if (!forkSubtree(nullptr, dirRight.second.second.get(), errorMsgNew, newFolder, level))
+            this->fillOneSide<RIGHT_SIDE>(*dirRight.second.second, errorMsgNew, newFolder, level + 1); //recurse
     },
 
-    [&](const FolderData& dirLeft, const FolderData& dirRight) //both sides
+    [&](FolderData& dirLeft, FolderData& dirRight) //both sides
     {
         FolderPair& newFolder = output.addSubFolder(dirLeft.first, dirLeft.second.first, DIR_EQUAL, dirRight.first, dirRight.second.first);
         const Zstringw* errorMsgNew = checkFailedRead(newFolder, errorMsg);
@@ -817,8 +1397,12 @@ void MergeSides::mergeTwoSides(const FolderContainer& lhs, const FolderContainer
             if (dirLeft.first != dirRight.first)
                 newFolder.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(newFolder));
 
-        mergeTwoSides(dirLeft.second.second, dirRight.second.second, errorMsgNew, newFolder); //recurse
+        if (!forkSubtree(dirLeft.second.second.get(), dirRight.second.second.get(), errorMsgNew, newFolder, level))
+            mergeTwoSides(*dirLeft.second.second, *dirRight.second.second, errorMsgNew, newFolder, level + 1); //recurse
     });
+
+    consumeMerged< LEFT_SIDE>(lhs); //lhs and rhs may alias: release not before both are merged
+    consumeMerged<RIGHT_SIDE>(rhs); //
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -849,24 +1433,12 @@ void stripExcludedDirectories(ContainerObject& hierObj, const HardFilter& filter
 }
 
 
-//create comparison result table and fill category except for files existing on both sides: undefinedFiles and undefinedSymlinks are appended!
-std::shared_ptr<BaseFolderPair> ComparisonBuffer::performComparison(const ResolvedFolderPair& fp,
-                                                                    const FolderPairCfg& fpCfg,
-                                                                    std::vector<FilePair*>& undefinedFiles,
-                                                                    std::vector<SymlinkPair*>& undefinedSymlinks) const
+//create comparison result table and fill category except for files existing on both sides
+ComparisonBuffer::MergedFolderPair ComparisonBuffer::performComparison(const ResolvedFolderPair& fp, const FolderPairCfg& fpCfg,
+                                                                       DirectoryValue* bufValueLeft, DirectoryValue* bufValueRight,
+                                                                       bool consumeLeft, bool consumeRight,
+                                                                       MergeThreadGroup* mergeThreads, size_t mergeThreadCount) const
 {
-    cb_.reportStatus(_("Generating file list...")); //throw X
-    cb_.forceUiRefresh(); //throw X
-
-    auto getDirValue = [&](const AbstractPath& folderPath) -> const DirectoryValue*
-    {
-        auto it = directoryBuffer_.find({ folderPath, fpCfg.filter.nameFilter, fpCfg.handleSymlinks });
-        return it != directoryBuffer_.end() ? &it->second : nullptr;
-    };
-
-    const DirectoryValue* bufValueLeft  = getDirValue(fp.folderPathLeft);
-    const DirectoryValue* bufValueRight = getDirValue(fp.folderPathRight);
-
     std::map<Zstring, Zstringw, LessFilePath> failedReads; //base-relative paths or empty if read-error for whole base directory
     {
         auto append = [&](const std::map<Zstring, std::wstring, LessFilePath>& c)
@@ -901,9 +1473,12 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::performComparison(const Resolv
                                                                               fpCfg.ignoreTimeShiftMinutes);
 
     //PERF_START;
+    std::vector<FilePair*> undefinedFiles;
+    std::vector<SymlinkPair*> undefinedSymlinks;
     FolderContainer emptyFolderCont; //WTF!!! => using a temporary in the ternary conditional would implicitly call the FolderContainer copy-constructor!!!!!!
-    MergeSides(failedReads, undefinedFiles, undefinedSymlinks).execute(bufValueLeft  ? bufValueLeft ->folderCont : emptyFolderCont,
-                                                                       bufValueRight ? bufValueRight->folderCont : emptyFolderCont, *output);
+    MergeSides(failedReads, undefinedFiles, undefinedSymlinks, consumeLeft, consumeRight).execute(bufValueLeft  ? bufValueLeft ->folderCont : emptyFolderCont,
+                                                                                                  bufValueRight ? bufValueRight->folderCont : emptyFolderCont, *output,
+                                                                                                  mergeThreads, mergeThreadCount); //throw std::bad_alloc
     //PERF_STOP;
 
     //##################### in/exclude rows according to filtering #####################
@@ -917,7 +1492,16 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::performComparison(const Resolv
     addSoftFiltering(*output, fpCfg.filter.timeSizeFilter);
 
     //##################################################################################
-    return output;
+    return { output, std::move(undefinedFiles), std::move(undefinedSymlinks) };
+}
+
+
+ComparisonBuffer::MergedFolderPair ComparisonBuffer::takeMergedPair(size_t pairIdx)
+{
+    assert(mergedPairs_[pairIdx]);
+    MergedFolderPair mfp = std::move(*mergedPairs_[pairIdx]);
+    mergedPairs_[pairIdx].reset();
+    return mfp;
 }
 }
 
@@ -930,6 +1514,9 @@ void fff::logNonDefaultSettings(const XmlGlobalSettings& activeSettings, Process
     if (activeSettings.failSafeFileCopy != defaultSettings.failSafeFileCopy)
         changedSettingsMsg += L"\n    " + _("Fail-safe file copy") + L" - " + (activeSettings.failSafeFileCopy ? _("Enabled") : _("Disabled"));
 
+    if (activeSettings.cacheNeutralFileCopy != defaultSettings.cacheNeutralFileCopy)
+        changedSettingsMsg += L"\n    " + _("Cache-neutral file copy") + L" - " + (activeSettings.cacheNeutralFileCopy ? _("Enabled") : _("Disabled"));
+
     if (activeSettings.copyLockedFiles != defaultSettings.copyLockedFiles)
         changedSettingsMsg += L"\n    " + _("Copy locked files") + L" - " + (activeSettings.copyLockedFiles ? _("Enabled") : _("Disabled"));
 
@@ -951,6 +1538,15 @@ void fff::logNonDefaultSettings(const XmlGlobalSettings& activeSettings, Process
     if (activeSettings.verifyFileCopy != defaultSettings.verifyFileCopy)
         changedSettingsMsg += L"\n    " + _("Verify copied files") + L" - " + (activeSettings.verifyFileCopy ? _("Enabled") : _("Disabled"));
 
+    if (activeSettings.adaptiveParallelOps != defaultSettings.adaptiveParallelOps)
+        changedSettingsMsg += L"\n    " + _("Adaptive parallel file operations") + L" - " + (activeSettings.adaptiveParallelOps ? _("Enabled") : _("Disabled"));
+
+    if (activeSettings.incrementalScan != defaultSettings.incrementalScan)
+        changedSettingsMsg += L"\n    " + _("Incremental folder scan") + L" - " + (activeSettings.incrementalScan ? _("Enabled") : _("Disabled"));
+
+    if (activeSettings.detectMovedFilesByContent != defaultSettings.detectMovedFilesByContent)
+        changedSettingsMsg += L"\n    " + _("Detect moved files by content") + L" - " + (activeSettings.detectMovedFilesByContent ? _("Enabled") : _("Disabled"));
+
     if (!changedSettingsMsg.empty())
         callback.reportInfo(_("Using non-default global settings:") + changedSettingsMsg); //throw X
 }
@@ -965,6 +1561,9 @@ FolderComparison fff::compare(WarningDialogs& warnings,
                               std::unique_ptr<LockHolder>& dirLocks,
                               const std::vector<FolderPairCfg>& fpCfgList,
                               const std::map<AbstractPath, size_t>& deviceParallelOps,
+                              size_t adaptiveParallelOpsMax,
+                              size_t fullRescanInterval,
+                              uint64_t moveDetectionByContentMinSize,
                               ProcessCallback& callback)
 {
     //PERF_START;
@@ -1080,30 +1679,32 @@ FolderComparison fff::compare(WarningDialogs& warnings,
 
         //reduce peak memory by restricting lifetime of ComparisonBuffer to have ended when loading potentially huge InSyncFolder instance in redetermineSyncDirection()
         {
-            //------------ traverse/read folders -----------------------------------------------------
+            //------------ traverse/read folders + merge folder pairs ---------------------------------
             //PERF_START;
-            ComparisonBuffer cmpBuff(foldersToRead, deviceParallelOps, fileTimeTolerance, callback);
+            ComparisonBuffer cmpBuff(workLoad, foldersToRead, deviceParallelOps, adaptiveParallelOpsMax, fullRescanInterval, fileTimeTolerance, callback);
             //PERF_STOP;
 
             //process binary comparison as one junk
-            std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>> workLoadByContent;
-            for (const auto& w : workLoad)
-                if (w.second.compareVar == CompareVariant::CONTENT)
-                    workLoadByContent.push_back(w);
+            std::vector<size_t> workLoadByContent;
+            for (size_t pairIdx = 0; pairIdx < workLoad.size(); ++pairIdx)
+                if (workLoad[pairIdx].second.compareVar == CompareVariant::CONTENT ||
+                    workLoad[pairIdx].second.compareVar == CompareVariant::CONTENT_CACHED)
+                    workLoadByContent.push_back(pairIdx);
 
             std::list<std::shared_ptr<BaseFolderPair>> outputByContent = cmpBuff.compareByContent(workLoadByContent);
 
             //write output in expected order
-            for (const auto& w : workLoad)
-                switch (w.second.compareVar)
+            for (size_t pairIdx = 0; pairIdx < workLoad.size(); ++pairIdx)
+                switch (workLoad[pairIdx].second.compareVar)
                 {
                     case CompareVariant::TIME_SIZE:
-                        output.push_back(cmpBuff.compareByTimeSize(w.first, w.second));
+                        output.push_back(cmpBuff.compareByTimeSize(pairIdx));
                         break;
                     case CompareVariant::SIZE:
-                        output.push_back(cmpBuff.compareBySize(w.first, w.second));
+                        output.push_back(cmpBuff.compareBySize(pairIdx));
                         break;
                     case CompareVariant::CONTENT:
+                    case CompareVariant::CONTENT_CACHED:
                         assert(!outputByContent.empty());
                         if (!outputByContent.empty())
                         {
@@ -1130,6 +1731,9 @@ FolderComparison fff::compare(WarningDialogs& warnings,
                 [&](const std::wstring& msg) { callback.reportStatus(msg); }); //throw X
 
             }, callback); //throw X
+
+            if (moveDetectionByContentMinSize > 0 && detectMovedFilesEnabled(fpCfg.directionCfg))
+                detectMovedFilesByContent(*it, moveDetectionByContentMinSize, deviceParallelOps, callback); //throw X
         }
 
         return output;
@@ -60,6 +60,9 @@ FolderComparison compare(WarningDialogs& warnings,
                          std::unique_ptr<LockHolder>& dirLocks, //out
                          const std::vector<FolderPairCfg>& fpCfgList,
                          const std::map<AbstractPath, size_t>& deviceParallelOps,
+                         size_t adaptiveParallelOpsMax, //tune deviceParallelOps at runtime up to this limit; 0: disabled
+                         size_t fullRescanInterval,     //incremental scan: reuse listings of unchanged folders, full rescan every N-th run; 0: disabled
+                         uint64_t moveDetectionByContentMinSize, //pair one-sided files by content if move detection is enabled; 0: disabled
                          ProcessCallback& callback);
 }
 
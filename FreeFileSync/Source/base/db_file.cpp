@@ -8,6 +8,8 @@
 #include <zen/guid.h>
 #include <zen/crc.h>
 #include <wx+/zlib_wrap.h>
+#include "ffs_paths.h"
+#include "../fs/native.h"
 
 
 using namespace zen;
@@ -56,6 +58,24 @@ AbstractPath getDatabaseFilePath(const BaseFolderPair& baseFolder, bool tempfile
     return AFS::appendRelPath(baseFolder.getAbstractPath<side>(), dbFileName);
 }
 
+
+AbstractPath getFolderCacheFilePath(const AbstractPath& baseFolderPath, const Zstring& cacheName, bool tempfile = false)
+{
+    //*.ffs_db ending: ignored by RealtimeSync
+    //not in base folder: writing the cache file would change the folder's change stamp => no incremental rescan of the base folder
+    const Zstring cacheFilePathNoExt = getFolderCacheFilePathNoExt(AFS::getInitPathPhrase(baseFolderPath), cacheName);
+    Zstring cacheFilePath;
+    if (tempfile)
+    {
+        const Zstring shortGuid = printNumber<Zstring>(Zstr("%04x"), static_cast<unsigned int>(getCrc16(generateGUID())));
+        cacheFilePath = cacheFilePathNoExt + Zstr('.') + shortGuid + AFS::TEMP_FILE_ENDING;
+    }
+    else
+        cacheFilePath = cacheFilePathNoExt + SYNC_DB_FILE_ENDING;
+
+    return createItemPathNativeNoFormatting(cacheFilePath);
+}
+
 //#######################################################################################################################################
 
 void saveStreams(const DbStreams& streamList, const AbstractPath& dbPath, const IOCallback& notifyUnbufferedIO) //throw FileError
@@ -934,3 +954,106 @@ void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, const std::
     AFS::renameItem(dbPathRightTmp, dbPathRight); //
     guardTmpR.dismiss();
 }
+
+
+void fff::loadFolderCacheFile(const AbstractPath& baseFolderPath, const Zstring& cacheName, int formatVer, //throw FileError
+                              const std::function<void(MemoryStreamIn<ByteArray>& streamIn)>& readPayload, //throw UnexpectedEndOfStreamError
+                              const std::function<void(const std::wstring& statusMsg)>& notifyStatus)
+{
+    const AbstractPath cachePath = getFolderCacheFilePath(baseFolderPath, cacheName);
+    if (notifyStatus) notifyStatus(replaceCpy(_("Loading file %x..."), L"%x", fmtPath(AFS::getDisplayPath(cachePath))));
+
+    const std::string formatDescr = "FreeFileSync " + utfTo<std::string>(cacheName);
+    try
+    {
+        ByteArray rawStream;
+        try
+        {
+            const std::unique_ptr<AFS::InputStream> fileStreamIn = AFS::getInputStream(cachePath, nullptr /*notifyUnbufferedIO*/); //throw FileError, ErrorFileLocked
+
+            std::string formatDescrFile(formatDescr.size() + 1, '\0'); //including 0-termination
+            readArray(*fileStreamIn, &formatDescrFile[0], formatDescrFile.size()); //throw FileError, ErrorFileLocked, UnexpectedEndOfStreamError
+
+            if (formatDescrFile != std::string(formatDescr.c_str(), formatDescr.size() + 1) ||
+                readNumber<int32_t>(*fileStreamIn) != formatVer) //throw FileError, ErrorFileLocked, UnexpectedEndOfStreamError
+                throw FileError(replaceCpy(_("Database file %x is incompatible."), L"%x", fmtPath(AFS::getDisplayPath(cachePath))));
+
+            //cache file name is only a checksum of the base folder path:
+            if (readContainer<std::string>(*fileStreamIn) != utfTo<std::string>(AFS::getInitPathPhrase(baseFolderPath))) //throw FileError, ErrorFileLocked, UnexpectedEndOfStreamError
+                return; //=> overwritten by saveFolderCacheFile()
+
+            rawStream = readContainer<ByteArray>(*fileStreamIn); //throw FileError, ErrorFileLocked, UnexpectedEndOfStreamError
+        }
+        catch (FileError&)
+        {
+            bool cacheNotYetExisting = false;
+            try { cacheNotYetExisting = !AFS::getItemTypeIfExists(cachePath); /*throw FileError*/ }
+            catch (FileError&) {} //previous exception is more relevant
+
+            if (cacheNotYetExisting)
+                return;
+            throw;
+        }
+
+        try
+        {
+            rawStream = decompress(rawStream); //throw ZlibInternalError
+        }
+        catch (ZlibInternalError&)
+        {
+            throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(AFS::getDisplayPath(cachePath))), L"Zlib internal error");
+        }
+
+        MemoryStreamIn<ByteArray> streamIn(rawStream);
+        readPayload(streamIn); //throw UnexpectedEndOfStreamError
+    }
+    catch (UnexpectedEndOfStreamError&)
+    {
+        throw FileError(_("Database file is corrupted:") + L"\n" + fmtPath(AFS::getDisplayPath(cachePath)), L"Unexpected end of stream.");
+    }
+    catch (const std::bad_alloc& e)
+    {
+        throw FileError(_("Database file is corrupted:") + L"\n" + fmtPath(AFS::getDisplayPath(cachePath)),
+                        _("Out of memory.") + L" " + utfTo<std::wstring>(e.what()));
+    }
+}
+
+
+void fff::saveFolderCacheFile(const AbstractPath& baseFolderPath, const Zstring& cacheName, int formatVer, //throw FileError
+                              const std::function<void(MemoryStreamOut<ByteArray>& streamOut)>& writePayload,
+                              const std::function<void(const std::wstring& statusMsg)>& notifyStatus)
+{
+    const AbstractPath cachePath    = getFolderCacheFilePath(baseFolderPath, cacheName);
+    const AbstractPath cachePathTmp = getFolderCacheFilePath(baseFolderPath, cacheName, true /*tempfile*/);
+    if (notifyStatus) notifyStatus(replaceCpy(_("Saving file %x..."), L"%x", fmtPath(AFS::getDisplayPath(cachePath))));
+
+    const std::string formatDescr = "FreeFileSync " + utfTo<std::string>(cacheName);
+
+    MemoryStreamOut<ByteArray> streamOut;
+    writePayload(streamOut);
+
+    ByteArray rawStream;
+    try
+    {
+        rawStream = compress(streamOut.ref(), 3); //throw ZlibInternalError; same level as sync.ffs_db
+    }
+    catch (ZlibInternalError&)
+    {
+        throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(AFS::getDisplayPath(cachePath))), L"zlib internal error");
+    }
+
+    //write temp file as a transaction
+    {
+        const std::unique_ptr<AFS::OutputStream> fileStreamOut = AFS::getOutputStream(cachePathTmp, nullptr /*streamSize*/, nullptr /*notifyUnbufferedIO*/); //throw FileError
+        writeArray(*fileStreamOut, formatDescr.c_str(), formatDescr.size() + 1); //throw FileError
+        writeNumber<int32_t>(*fileStreamOut, formatVer);                           //
+        writeContainer<std::string>(*fileStreamOut, utfTo<std::string>(AFS::getInitPathPhrase(baseFolderPath))); //
+        writeContainer<ByteArray>(*fileStreamOut, rawStream);                      //
+        fileStreamOut->finalize(); //throw FileError
+    }
+    ZEN_ON_SCOPE_FAIL(try { AFS::removeFilePlain(cachePathTmp); }
+    catch (FileError&) {});
+
+    AFS::removeFileIfExists(cachePath);        //throw FileError
+    AFS::renameItem(cachePathTmp, cachePath); //throw FileError, (ErrorDifferentVolume)
+}
@@ -99,6 +99,21 @@ std::shared_ptr<InSyncFolder> loadLastSynchronousState(const BaseFolderPair& bas
 
 void saveLastSynchronousState(const BaseFolderPair& baseDirObj, //throw FileError
                               const std::function<void(const std::wstring& statusMsg)>& notifyStatus);
+
+//------------------------------------------------------------------------------------------------------------------
+/*
+per-base-folder cache file, stored in config directory: "FreeFileSync <cacheName>" | formatVer | base folder path phrase | zlib(payload)
+    - file name is only a checksum of the base folder path phrase => mismatching phrase is treated like a missing cache file
+    - formatVer: owned by the caller, bump for incompatible payload changes
+*/
+//call from main thread only: see getConfigDirPathPf()
+void loadFolderCacheFile(const AbstractPath& baseFolderPath, const Zstring& cacheName, int formatVer, //throw FileError; readPayload() not called if not yet existing
+                         const std::function<void(zen::MemoryStreamIn<zen::ByteArray>& streamIn)>& readPayload, //throw UnexpectedEndOfStreamError
+                         const std::function<void(const std::wstring& statusMsg)>& notifyStatus);
+
+void saveFolderCacheFile(const AbstractPath& baseFolderPath, const Zstring& cacheName, int formatVer, //throw FileError
+                         const std::function<void(zen::MemoryStreamOut<zen::ByteArray>& streamOut)>& writePayload,
+                         const std::function<void(const std::wstring& statusMsg)>& notifyStatus);
 }
 
 #endif //DB_FILE_H_834275398588021574
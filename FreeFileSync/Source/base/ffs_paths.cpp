@@ -6,6 +6,7 @@
 
 #include "ffs_paths.h"
 #include <zen/file_access.h>
+#include <zen/crc.h>
 #include <wx/stdpaths.h>
 #include <wx/app.h>
 
@@ -68,6 +69,21 @@ Zstring fff::getConfigDirPathPf()
 }
 
 
+Zstring fff::getFolderCacheFilePathNoExt(const Zstring& folderPathPhrase, const Zstring& cacheName)
+{
+    const Zstring cacheDirPath = getConfigDirPathPf() + Zstr("Cache");
+    try
+    {
+        createDirectoryIfMissingRecursion(cacheDirPath); //throw FileError
+    }
+    catch (FileError&) { assert(false); } //=> caller fails writing the cache file
+
+    //folder path phrases may be long and contain any characters => use checksum; caller must handle collisions!
+    return appendSeparator(cacheDirPath) + cacheName + Zstr('.') +
+           printNumber<Zstring>(Zstr("%08x"), static_cast<unsigned int>(getCrc32(utfTo<std::string>(folderPathPhrase))));
+}
+
+
 //this function is called by RealTimeSync!!!
 Zstring fff::getFreeFileSyncLauncherPath()
 {
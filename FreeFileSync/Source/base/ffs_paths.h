@@ -19,6 +19,9 @@ Zstring getResourceDirPf  (); //resource directory WITH trailing path separator
 Zstring getConfigDirPathPf(); //config directory WITH trailing path separator
 //------------------------------------------------------------------------------
 
+//per-folder cache file in config directory (=> don't write into synced folders): file name without extension
+Zstring getFolderCacheFilePathNoExt(const Zstring& folderPathPhrase, const Zstring& cacheName);
+
 bool isPortableVersion();
 
 
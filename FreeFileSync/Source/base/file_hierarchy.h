@@ -8,6 +8,8 @@
 #define FILE_HIERARCHY_H_257235289645296
 
 #include <map>
+#include <vector>
+#include <algorithm>
 //#include <cstddef> //required by GCC 4.9 to find ptrdiff_t
 #include <string>
 #include <memory>
@@ -16,6 +18,7 @@
 #include <unordered_set>
 #include <zen/zstring.h>
 #include <zen/stl_tools.h>
+#include <zen/scope_guard.h>
 #include <zen/file_id_def.h>
 #include "structures.h"
 #include "hard_filter.h"
@@ -104,12 +107,17 @@ std::wstring getShortDisplayNameForFolderPair(const AbstractPath& itemPathL, con
 
 //------------------------------------------------------------------
 
+/*
+scan result of one folder: sorted contiguous arrays instead of node-based maps => less memory per item, no pointer chasing in MergeSides
+    - scanning only appends; freeze() sorts and removes duplicates once all items are in
+    - sub-folder containers are allocated separately: references stay valid while the parent folder's list grows (see parallel_scan.cpp)
+*/
 struct FolderContainer
 {
     //------------------------------------------------------------------
-    using FolderList  = std::map<Zstring, std::pair<FolderAttributes, FolderContainer>, LessFilePath>; //
-    using FileList    = std::map<Zstring, FileAttributes,  LessFilePath>; //key: file name
-    using SymlinkList = std::map<Zstring, LinkAttributes,  LessFilePath>; //
+    using FileList    = std::vector<std::pair<Zstring, FileAttributes>>; //sorted by item name (LessFilePath) after freeze()
+    using SymlinkList = std::vector<std::pair<Zstring, LinkAttributes>>; //
+    using FolderList  = std::vector<std::pair<Zstring, std::pair<FolderAttributes, std::unique_ptr<FolderContainer>>>>; //
     //------------------------------------------------------------------
 
     FolderContainer() = default;
@@ -120,30 +128,45 @@ struct FolderContainer
     SymlinkList symlinks; //non-followed symlinks
     FolderList  folders;
 
-    void addSubFile(const Zstring& itemName, const FileAttributes& attr)
+    void addSubFile(const Zstring& itemName, const FileAttributes& attr) { files   .emplace_back(itemName, attr); }
+    void addSubLink(const Zstring& itemName, const LinkAttributes& attr) { symlinks.emplace_back(itemName, attr); }
+
+    FolderContainer& addSubFolder(const Zstring& itemName, const FolderAttributes& attr)
     {
-        auto rv = files.emplace(itemName, attr);
-        if (!rv.second) //update entry if already existing (e.g. during folder traverser "retry") => does not handle different item name case (irrelvant!..)
-            rv.first->second = attr;
+        folders.emplace_back(itemName, std::make_pair(attr, std::make_unique<FolderContainer>()));
+        return *folders.back().second.second;
     }
 
-    void addSubLink(const Zstring& itemName, const LinkAttributes& attr)
+    void freeze() //call after sub folders are filled, too
     {
-        auto rv = symlinks.emplace(itemName, attr);
-        if (!rv.second)
-            rv.first->second = attr;
+        freezeList(files);
+        freezeList(symlinks);
+        freezeList(folders);
+
+        for (auto& [folderName, attrAndCont] : folders)
+            attrAndCont.second->freeze(); //recurse
     }
 
-    FolderContainer& addSubFolder(const Zstring& itemName, const FolderAttributes& attr)
+private:
+    template <class List>
+    static void freezeList(List& items)
     {
-        auto& p = folders[itemName]; //value default-construction is okay here
-        p.first = attr;
-        return p.second;
-
-        //auto rv = folders.emplace(itemName, std::pair<FolderAttributes, FolderContainer>(attr, FolderContainer()));
-        //if (!rv.second)
-        //  rv.first->second.first = attr;
-        //return rv.first->second.second;
+        auto lessName = [](const auto& lhs, const auto& rhs) { return LessFilePath()(lhs.first, rhs.first); };
+
+        if (!std::is_sorted(items.begin(), items.end(), lessName))
+            std::stable_sort(items.begin(), items.end(), lessName);
+
+        //same name added twice (e.g. during folder traverser "retry"): keep the last entry => does not handle different item name case (irrelvant!..)
+        auto itOut = items.begin();
+        for (auto it = items.begin(); it != items.end(); ++it)
+            if (std::next(it) == items.end() || lessName(*it, *std::next(it)))
+            {
+                if (itOut != it)
+                    *itOut = std::move(*it);
+                ++itOut;
+            }
+        items.erase(itOut, items.end());
+        items.shrink_to_fit(); //capacity was only needed while scanning
     }
 };
 
@@ -396,9 +419,55 @@ public:
     }
     static T* retrieve(ObjectId id) { return const_cast<T*>(retrieve(static_cast<ObjectIdConst>(id))); }
 
+    //parallel construction (e.g. MergeSides): collect the objects created/deleted by a worker thread, register them later on the controlling thread
+    class DeferredRegistration
+    {
+    public:
+        //context of worker thread (nesting allowed, e.g. subtree merged by the thread merging the folder pair):
+        template <class Function>
+        void collect(Function constructObjects)
+        {
+            auto deferredOld = deferred_;
+            deferred_ = &changes_;
+            ZEN_ON_SCOPE_EXIT(deferred_ = deferredOld);
+            constructObjects();
+        }
+
+        //context of controlling thread, after worker is done:
+        void commit()
+        {
+            if (deferred_) //controlling thread is collecting, too (nested parallel construction)
+                deferred_->insert(deferred_->end(), changes_.begin(), changes_.end());
+            else
+                for (const auto& [obj, active] : changes_)
+                    if (active)
+                        activeObjects().insert(obj);
+                    else
+                        activeObjects().erase(obj);
+            changes_.clear();
+        }
+
+    private:
+        std::vector<std::pair<const ObjectMgr*, bool /*active*/>> changes_; //keep order: address may be reused after deletion
+    };
+
 protected:
-    ObjectMgr () { activeObjects().insert(this); }
-    ~ObjectMgr() { activeObjects().erase (this); }
+    static bool registrationDeferred() { return deferred_; } //constructing a new tree on a worker thread
+
+    ObjectMgr ()
+    {
+        if (deferred_)
+            deferred_->emplace_back(this, true);
+        else
+            activeObjects().insert(this);
+    }
+    ~ObjectMgr()
+    {
+        if (deferred_)
+            deferred_->emplace_back(this, false);
+        else
+            activeObjects().erase(this);
+    }
 
 private:
     ObjectMgr           (const ObjectMgr& rhs) = delete;
@@ -412,6 +481,8 @@ private:
         static std::unordered_set<const ObjectMgr*> inst;
         return inst; //external linkage (even in header file!)
     }
+
+    static inline thread_local std::vector<std::pair<const ObjectMgr*, bool>>* deferred_ = nullptr;
 };
 
 //------------------------------------------------------------------
@@ -468,14 +539,20 @@ protected:
         parent_(parentObj)
     {
         assert(itemNameL_.c_str() == itemNameR_.c_str() || itemNameL_ != itemNameR_); //also checks ref-counted string precondition
-        parent_.notifySyncCfgChanged();
+        if (!registrationDeferred()) //see notifySyncCfgChanged()
+            parent_.notifySyncCfgChanged();
     }
 
     virtual ~FileSystemObject() {} //don't need polymorphic deletion, but we have a vtable anyway
     //must not call parent here, it is already partially destroyed and nothing more than a pure ContainerObject!
 
     virtual void flip();
-    virtual void notifySyncCfgChanged() { parent().notifySyncCfgChanged(); /*propagate!*/ }
+    virtual void notifySyncCfgChanged()
+    {
+        //parallel merge (see MergeSides): new tree => no sync operations were buffered by parent folders yet, and sibling subtrees share these parents!
+        if (!registrationDeferred())
+            parent().notifySyncCfgChanged(); //propagate!
+    }
 
     void setSynced(const Zstring& itemName);
 
@@ -10,6 +10,7 @@
 #include <vector>
 #include <typeinfo>
 #include <iterator>
+#include <array>
 
 using namespace zen;
 using namespace fff;
@@ -118,6 +119,7 @@ struct AnyMatch
 };
 
 
+//reference semantics of a single mask; see MaskMatcher for the compiled version used by NameFilter
 template <class PathEndMatcher>
 bool matchesMask(const Zchar* path, const Zchar* mask)
 {
@@ -203,21 +205,365 @@ bool matchesMaskBegin(const Zchar* str, const Zchar* mask)
 }
 
 
-template <class PathEndMatcher> inline
-bool matchesMask(const Zstring& name, const std::vector<Zstring>& masks)
-{
-    return std::any_of(masks.begin(), masks.end(), [&](const Zstring& mask) { return matchesMask<PathEndMatcher>(name.c_str(), mask.c_str()); });
-}
-
-
 inline
 bool matchesMaskBegin(const Zstring& name, const std::vector<Zstring>& masks)
 {
     return std::any_of(masks.begin(), masks.end(), [&](const Zstring& mask) { return matchesMaskBegin(name.c_str(), mask.c_str()); });
 }
+/*
+mask set compiled at construction: same result as matchesMask<AnyMatch>(path, masksAnyMatch) || matchesMask<ParentFolderMatch>(path, masksParentFolderMatch),
+but evaluated in one pass over the path instead of once per mask => cost no longer grows with the number of masks
+    - "*literal" (e.g. *.tmp): reversed trie, walked backwards from each possible match end: path separator or end of path
+    - literal prefix of all other masks: trie walked along the path
+    - wildcard tail following the literal prefix: NFA of all tails, simulated bit-parallel (Shift-And): one bit per mask position
+*/
+class MaskMatcher
+{
+public:
+    MaskMatcher(const std::vector<Zstring>& masksAnyMatch, const std::vector<Zstring>& masksParentFolderMatch)
+    {
+        std::vector<NfaItem> nfa;
+        for (const Zstring& mask : masksAnyMatch)          addMask(mask, END_ANY,    nfa);
+        for (const Zstring& mask : masksParentFolderMatch) addMask(mask, END_PARENT, nfa);
+        compileNfa(nfa);
+    }
+
+    struct State //after matching a folder path postfixed with FILE_NAME_SEPARATOR
+    {
+        size_t pathLen = 0;
+        bool matched = false; //=> all child paths match, too
+        uint32_t node = 0;             //prefix trie position
+        std::vector<uint64_t> active; //NFA positions; empty if none
+    };
+
+    bool matches(const Zstring& path, const State* parentState /*optional*/) const
+    {
+        if (parentState && parentState->matched)
+            return true;
+        return run(path, parentState, nullptr);
+    }
+
+    State getChildState(const Zstring& folderPathPf, const State* parentState /*optional*/) const
+    {
+        assert(endsWith(folderPathPf, FILE_NAME_SEPARATOR));
+        State state;
+        state.matched = (parentState && parentState->matched) || run(folderPathPf, parentState, &state);
+        state.pathLen = folderPathPf.size();
+        return state;
+    }
+
+private:
+    //stateOut == nullptr: match full path
+    //stateOut != nullptr: path is a folder prefix of child paths => no match end at end of path; return NFA and trie state
+    bool run(const Zstring& path, const State* parentState, State* stateOut) const
+    {
+        const Zchar* const pathFirst = path.c_str();
+        const Zchar* const pathStart = pathFirst + (parentState ? parentState->pathLen : 0);
+        assert(!parentState || (path.size() >= parentState->pathLen && (parentState->pathLen == 0 || path[parentState->pathLen - 1] == FILE_NAME_SEPARATOR)));
+
+        if (suffixTrie_.size() > 1)
+            for (const Zchar* it = pathStart;; ++it)
+            {
+                const Zchar c = *it;
+                if (c == 0 && stateOut)
+                    break;
+                if ((c == FILE_NAME_SEPARATOR || c == 0) && matchesSuffix(pathFirst, it))
+                    return true;
+                if (c == 0)
+                    break;
+            }
+
+        //NFA positions waiting for the next path char
+        uint64_t activeBuf[8] = {}; //avoid heap allocation for typical mask counts
+        std::vector<uint64_t> activeHeap(words_ > std::size(activeBuf) ? words_ : 0);
+        uint64_t* const active = activeHeap.empty() ? activeBuf : activeHeap.data();
+        bool activeEmpty = true;
+        uint32_t node = 0; //prefix trie position
+
+        if (parentState)
+        {
+            node = parentState->node;
+            if (!parentState->active.empty())
+            {
+                std::copy(parentState->active.begin(), parentState->active.end(), active);
+                activeEmpty = false;
+            }
+        }
+        if (stateOut)
+            stateOut->node = NO_NODE; //in case of early exit: no child path can match
+
+        for (const Zchar* it = pathStart;; ++it)
+        {
+            const Zchar c = *it;
+            if (c == 0 && stateOut)
+            {
+                stateOut->node = node;
+                if (!activeEmpty)
+                    stateOut->active.assign(active, active + words_);
+                return false;
+            }
+
+            if (node != NO_NODE)
+            {
+                const TrieNode& tn = prefixTrie_[node];
+                if (endMatches(tn.endFlags, c))
+                    return true;
+
+                for (const uint32_t pos : tn.nfaStart)
+                    active[pos / 64] |= uint64_t(1) << (pos % 64);
+                activeEmpty &= tn.nfaStart.empty();
+            }
+
+            if (!activeEmpty)
+            {
+                //'*' matching empty string: the position following an active '*' is active, too
+                uint64_t carry = 0;
+                uint64_t anyActive = 0;
+                for (size_t i = 0; i < words_; ++i)
+                {
+                    const uint64_t star = active[i] & masks_[STAR_MASK][i];
+                    active[i] |= (star << 1) | carry;
+                    carry = star >> 63;
+                    anyActive |= active[i];
+
+                    if (active[i] & masks_[STAR_END_ANY_MASK][i]) //mask ends with '*' => matchesMaskStar() of AnyMatch
+                        return true;
+                    if (c == FILE_NAME_SEPARATOR ? active[i] & (masks_[END_ANY_MASK][i] | masks_[END_PARENT_MASK][i]) :
+                        c == 0                   ? active[i] &  masks_[END_ANY_MASK][i] : 0)
+                        return true;
+                }
+                activeEmpty = anyActive == 0;
+            }
+
+            if (c == 0 || (node == NO_NODE && activeEmpty))
+                return false;
+
+            if (!activeEmpty)
+            {
+                const std::vector<uint64_t>& charMask = masks_[CHAR_MASK_FIRST + charRow_[static_cast<std::make_unsigned_t<Zchar>>(c)]];
+                uint64_t carry = 0;
+                uint64_t anyActive = 0;
+                for (size_t i = 0; i < words_; ++i)
+                {
+                    const uint64_t consumed = active[i] & charMask[i];
+                    active[i] = (consumed << 1) | carry | (active[i] & masks_[STAR_MASK][i]);
+                    carry = consumed >> 63;
+                    anyActive |= active[i];
+                }
+                activeEmpty = anyActive == 0;
+            }
+
+            if (node != NO_NODE)
+                node = findChild(prefixTrie_[node], c);
+        }
+    }
+
+    enum : unsigned char //end of mask matches:
+    {
+        END_ANY    = 1, //AnyMatch
+        END_PARENT = 2, //ParentFolderMatch
+    };
+
+    static bool endMatches(unsigned char endFlags, Zchar ch) //ch: path char following the mask match
+    {
+        if (ch == FILE_NAME_SEPARATOR)
+            return endFlags != 0;
+        return ch == 0 && (endFlags & END_ANY);
+    }
+
+    static constexpr uint32_t NO_NODE = static_cast<uint32_t>(-1);
+
+    struct TrieNode
+    {
+        std::vector<std::pair<Zchar, uint32_t>> children; //sorted by char
+        unsigned char endFlags = 0;
+        std::vector<uint32_t> nfaStart; //wildcard tails following the literal prefix ending here
+    };
+
+    struct NfaItem
+    {
+        enum Type : unsigned char
+        {
+            CHAR,
+            ANY_CHAR, //?
+            STAR,     //*, never followed by another STAR
+            END,
+        } type;
+        Zchar ch;                   //CHAR only
+        unsigned char endFlags = 0; //END only
+    };
+
+    static uint32_t findChild(const TrieNode& tn, Zchar ch)
+    {
+        auto it = std::lower_bound(tn.children.begin(), tn.children.end(), ch, [](const std::pair<Zchar, uint32_t>& child, Zchar ch2) { return child.first < ch2; });
+        return it != tn.children.end() && it->first == ch ? it->second : NO_NODE;
+    }
+
+    static uint32_t insertChild(std::vector<TrieNode>& trie, uint32_t node, Zchar ch)
+    {
+        auto& children = trie[node].children;
+        auto it = std::lower_bound(children.begin(), children.end(), ch, [](const std::pair<Zchar, uint32_t>& child, Zchar ch2) { return child.first < ch2; });
+        if (it != children.end() && it->first == ch)
+            return it->second;
+
+        const auto child = static_cast<uint32_t>(trie.size());
+        children.insert(it, { ch, child });
+        trie.emplace_back(); //invalidates "children"
+        return child;
+    }
+
+    //"*literal": match ending at pathEnd?
+    bool matchesSuffix(const Zchar* pathFirst, const Zchar* pathEnd) const
+    {
+        uint32_t node = 0;
+        for (const Zchar* it = pathEnd; it != pathFirst;)
+        {
+            node = findChild(suffixTrie_[node], *--it);
+            if (node == NO_NODE)
+                return false;
+
+            if (endMatches(suffixTrie_[node].endFlags, *pathEnd))
+                return true;
+        }
+        return false;
+    }
+
+    void addMask(const Zstring& mask, unsigned char endFlag, std::vector<NfaItem>& nfa)
+    {
+        const Zchar* const maskEnd = mask.c_str() + mask.size();
+        const Zchar* const wildcard = std::find_if(mask.c_str(), maskEnd, [](Zchar c) { return c == Zstr('*') || c == Zstr('?'); });
+
+        if (wildcard == mask.c_str()) //"*literal"?
+        {
+            const Zchar* tail = wildcard;
+            while (*tail == Zstr('*'))
+                ++tail;
+
+            if (tail != wildcard && tail != maskEnd &&
+                std::none_of(tail, maskEnd, [](Zchar c) { return c == Zstr('*') || c == Zstr('?'); }))
+            {
+                uint32_t node = 0;
+                for (const Zchar* it = maskEnd; it != tail;)
+                    node = insertChild(suffixTrie_, node, *--it);
+                suffixTrie_[node].endFlags |= endFlag;
+                return;
+            }
+        }
+
+        uint32_t node = 0;
+        for (const Zchar* it = mask.c_str(); it != wildcard; ++it)
+            node = insertChild(prefixTrie_, node, *it);
+
+        if (wildcard == maskEnd)
+        {
+            prefixTrie_[node].endFlags |= endFlag;
+            return;
+        }
+
+        prefixTrie_[node].nfaStart.push_back(static_cast<uint32_t>(nfa.size()));
+        for (const Zchar* it = wildcard; it != maskEnd; ++it)
+            switch (*it)
+            {
+                case Zstr('*'):
+                    if (it == wildcard || nfa.back().type != NfaItem::STAR)
+                        nfa.push_back({ NfaItem::STAR, 0 });
+                    break;
+                case Zstr('?'):
+                    nfa.push_back({ NfaItem::ANY_CHAR, 0 });
+                    break;
+                default:
+                    nfa.push_back({ NfaItem::CHAR, *it });
+                    break;
+            }
+        nfa.push_back({ NfaItem::END, 0, endFlag });
+    }
+
+    void compileNfa(const std::vector<NfaItem>& nfa)
+    {
+        words_ = (nfa.size() + 63) / 64;
+
+        for (const NfaItem& item : nfa)
+            if (item.type == NfaItem::CHAR)
+            {
+                uint8_t& row = charRow_[static_cast<std::make_unsigned_t<Zchar>>(item.ch)];
+                if (row == 0) //row 0: "any other char"
+                {
+                    row = static_cast<uint8_t>(masks_.size() - CHAR_MASK_FIRST);
+                    masks_.emplace_back();
+                }
+            }
+
+        for (std::vector<uint64_t>& mask : masks_)
+            mask.resize(words_);
+
+        auto setBit = [&](size_t maskIdx, size_t pos) { masks_[maskIdx][pos / 64] |= uint64_t(1) << (pos % 64); };
+
+        for (size_t pos = 0; pos < nfa.size(); ++pos)
+        {
+            const NfaItem& item = nfa[pos];
+            switch (item.type)
+            {
+                case NfaItem::CHAR:
+                    setBit(CHAR_MASK_FIRST + charRow_[static_cast<std::make_unsigned_t<Zchar>>(item.ch)], pos);
+                    break;
+                case NfaItem::ANY_CHAR:
+                    for (size_t row = CHAR_MASK_FIRST; row < masks_.size(); ++row)
+                        setBit(row, pos);
+                    break;
+                case NfaItem::STAR:
+                    setBit(STAR_MASK, pos);
+                    if (nfa[pos + 1].type == NfaItem::END && (nfa[pos + 1].endFlags & END_ANY))
+                        setBit(STAR_END_ANY_MASK, pos);
+                    break;
+                case NfaItem::END:
+                    setBit(item.endFlags == END_ANY ? END_ANY_MASK : END_PARENT_MASK, pos);
+                    break;
+            }
+        }
+    }
+
+    std::vector<TrieNode> prefixTrie_ = std::vector<TrieNode>(1); //root: index 0
+    std::vector<TrieNode> suffixTrie_ = std::vector<TrieNode>(1); //reversed; nfaStart unused
+
+    enum
+    {
+        STAR_MASK,
+        STAR_END_ANY_MASK,
+        END_ANY_MASK,
+        END_PARENT_MASK,
+        CHAR_MASK_FIRST, //positions consuming a char: one row per char used in masks + row for any other char
+    };
+    std::vector<std::vector<uint64_t>> masks_ = std::vector<std::vector<uint64_t>>(CHAR_MASK_FIRST + 1); //bit sets of NFA positions
+    static_assert(sizeof(Zchar) == 1);
+    std::array<uint8_t, 256> charRow_{}; //char => row in masks_, starting at CHAR_MASK_FIRST
+    size_t words_ = 0;
+};
 }
 
 
+struct NameFilter::CompiledMasks
+{
+    CompiledMasks(const NameFilter& filter) :
+        excludeFile(filter.excludeMasksFileFolder, filter.excludeMasksFolder),
+        includeFile(filter.includeMasksFileFolder, filter.includeMasksFolder),
+        excludeDir (concatMasks(filter.excludeMasksFileFolder, filter.excludeMasksFolder), {}),
+        includeDir (concatMasks(filter.includeMasksFileFolder, filter.includeMasksFolder), {}) {}
+
+    const MaskMatcher excludeFile; //AnyMatch for file/folder masks, ParentFolderMatch for folder masks
+    const MaskMatcher includeFile; //
+    const MaskMatcher excludeDir; //AnyMatch for all masks
+    const MaskMatcher includeDir; //
+
+private:
+    static std::vector<Zstring> concatMasks(const std::vector<Zstring>& lhs, const std::vector<Zstring>& rhs)
+    {
+        std::vector<Zstring> output = lhs;
+        output.insert(output.end(), rhs.begin(), rhs.end());
+        return output;
+    }
+};
+
+
 std::vector<Zstring> fff::splitByDelimiter(const Zstring& filterString)
 {
     //delimiters may be FILTER_ITEM_SEPARATOR or '\n'
@@ -246,6 +592,8 @@ NameFilter::NameFilter(const Zstring& includePhrase, const Zstring& excludePhras
     removeDuplicates(includeMasksFolder);
     removeDuplicates(excludeMasksFileFolder);
     removeDuplicates(excludeMasksFolder);
+
+    compiledMasks = std::make_shared<const CompiledMasks>(*this);
 }
 
 
@@ -255,32 +603,66 @@ void NameFilter::addExclusion(const Zstring& excludePhrase)
 
     removeDuplicates(excludeMasksFileFolder);
     removeDuplicates(excludeMasksFolder);
+
+    compiledMasks = std::make_shared<const CompiledMasks>(*this);
 }
 
 
-bool NameFilter::passFileFilter(const Zstring& relFilePath) const
+class NameFilter::Cursor : public HardFilter::FolderCursor
+{
+public:
+    Cursor(const NameFilter& filter, const Cursor* parent /*optional*/, const Zstring& relDirPathPf) :
+        filter_(filter),
+        excludeFile(filter.compiledMasks->excludeFile.getChildState(relDirPathPf, parent ? &parent->excludeFile : nullptr)),
+        includeFile(filter.compiledMasks->includeFile.getChildState(relDirPathPf, parent ? &parent->includeFile : nullptr)),
+        excludeDir (filter.compiledMasks->excludeDir .getChildState(relDirPathPf, parent ? &parent->excludeDir  : nullptr)),
+        includeDir (filter.compiledMasks->includeDir .getChildState(relDirPathPf, parent ? &parent->includeDir  : nullptr)) {}
+
+    explicit Cursor(const NameFilter& filter) : filter_(filter) {} //base folder
+
+    bool passFileFilter(const Zstring& relFilePath) const override { return filter_.passFileFilter(relFilePath, this); }
+    bool passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const override { return filter_.passDirFilter(relDirPath, childItemMightMatch, this); }
+
+    std::unique_ptr<FolderCursor> getChildCursor(const Zstring& relDirPathPf) const override { return std::make_unique<Cursor>(filter_, this, relDirPathPf); }
+
+    const NameFilter& filter_;
+    const MaskMatcher::State excludeFile; //state of CompiledMasks after matching the folder path
+    const MaskMatcher::State includeFile; //
+    const MaskMatcher::State excludeDir;  //
+    const MaskMatcher::State includeDir;  //
+};
+
+
+std::unique_ptr<HardFilter::FolderCursor> NameFilter::getBaseCursor() const { return std::make_unique<Cursor>(*this); }
+
+
+bool NameFilter::passFileFilter(const Zstring& relFilePath) const { return passFileFilter(relFilePath, nullptr); }
+
+bool NameFilter::passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const { return passDirFilter(relDirPath, childItemMightMatch, nullptr); }
+
+
+bool NameFilter::passFileFilter(const Zstring& relFilePath, const Cursor* parentCursor) const
 {
     assert(!startsWith(relFilePath, FILE_NAME_SEPARATOR));
     const Zstring& pathFmt = relFilePath; //nothing to do here
 
-    if (matchesMask<AnyMatch         >(pathFmt, excludeMasksFileFolder) || //either full match on file or partial match on any parent folder
-        matchesMask<ParentFolderMatch>(pathFmt, excludeMasksFolder))       //partial match on any parent folder only
+    //file/folder masks: either full match on file or partial match on any parent folder
+    //folder masks: partial match on any parent folder only
+    if (compiledMasks->excludeFile.matches(pathFmt, parentCursor ? &parentCursor->excludeFile : nullptr))
         return false;
 
-    return matchesMask<AnyMatch         >(pathFmt, includeMasksFileFolder) ||
-           matchesMask<ParentFolderMatch>(pathFmt, includeMasksFolder);
+    return compiledMasks->includeFile.matches(pathFmt, parentCursor ? &parentCursor->includeFile : nullptr);
 }
 
 
-bool NameFilter::passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const
+bool NameFilter::passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch, const Cursor* parentCursor) const
 {
     assert(!startsWith(relDirPath, FILE_NAME_SEPARATOR));
     assert(!childItemMightMatch || *childItemMightMatch); //check correct usage
 
     const Zstring& pathFmt = relDirPath; //nothing to do here
 
-    if (matchesMask<AnyMatch>(pathFmt, excludeMasksFileFolder) ||
-        matchesMask<AnyMatch>(pathFmt, excludeMasksFolder))
+    if (compiledMasks->excludeDir.matches(pathFmt, parentCursor ? &parentCursor->excludeDir : nullptr))
     {
         if (childItemMightMatch)
             *childItemMightMatch = false; //perf: no need to traverse deeper; subfolders/subfiles would be excluded by filter anyway!
@@ -298,8 +680,7 @@ bool NameFilter::passDirFilter(const Zstring& relDirPath, bool* childItemMightMa
         return false;
     }
 
-    if (!matchesMask<AnyMatch>(pathFmt, includeMasksFileFolder) &&
-        !matchesMask<AnyMatch>(pathFmt, includeMasksFolder))
+    if (!compiledMasks->includeDir.matches(pathFmt, parentCursor ? &parentCursor->includeDir : nullptr))
     {
         if (childItemMightMatch)
         {
@@ -356,3 +737,115 @@ bool NameFilter::cmpLessSameType(const HardFilter& other) const
 
     return false; //all equal
 }
+
+//#################################################################################################
+
+namespace
+{
+class PathCursor : public HardFilter::FolderCursor //no incremental state: evaluate full paths
+{
+public:
+    explicit PathCursor(const HardFilter& filter) : filter_(filter) {}
+
+    bool passFileFilter(const Zstring& relFilePath) const override { return filter_.passFileFilter(relFilePath); }
+    bool passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const override { return filter_.passDirFilter(relDirPath, childItemMightMatch); }
+
+    std::unique_ptr<FolderCursor> getChildCursor(const Zstring& relDirPathPf) const override { return std::make_unique<PathCursor>(filter_); }
+
+private:
+    const HardFilter& filter_;
+};
+
+
+class CombinedCursor : public HardFilter::FolderCursor //harmonize with CombinedFilter!
+{
+public:
+    CombinedCursor(std::unique_ptr<FolderCursor>&& first, std::unique_ptr<FolderCursor>&& second) : first_(std::move(first)), second_(std::move(second)) {}
+
+    bool passFileFilter(const Zstring& relFilePath) const override
+    {
+        return first_ ->passFileFilter(relFilePath) && //short-circuit behavior
+               second_->passFileFilter(relFilePath);
+    }
+
+    bool passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const override
+    {
+        if (first_->passDirFilter(relDirPath, childItemMightMatch))
+            return second_->passDirFilter(relDirPath, childItemMightMatch);
+        else
+        {
+            if (childItemMightMatch && *childItemMightMatch)
+                second_->passDirFilter(relDirPath, childItemMightMatch);
+            return false;
+        }
+    }
+
+    std::unique_ptr<FolderCursor> getChildCursor(const Zstring& relDirPathPf) const override
+    {
+        return std::make_unique<CombinedCursor>(first_->getChildCursor(relDirPathPf), second_->getChildCursor(relDirPathPf));
+    }
+
+private:
+    const std::unique_ptr<FolderCursor> first_;
+    const std::unique_ptr<FolderCursor> second_;
+};
+
+
+class UnionCursor : public HardFilter::FolderCursor //harmonize with UnionFilter!
+{
+public:
+    explicit UnionCursor(std::vector<std::unique_ptr<FolderCursor>>&& cursors) : cursors_(std::move(cursors)) {}
+
+    bool passFileFilter(const Zstring& relFilePath) const override
+    {
+        return std::any_of(cursors_.begin(), cursors_.end(), [&](const std::unique_ptr<FolderCursor>& cursor) { return cursor->passFileFilter(relFilePath); });
+    }
+
+    bool passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const override
+    {
+        bool childMightMatch = false;
+        for (const std::unique_ptr<FolderCursor>& cursor : cursors_)
+        {
+            bool childMightMatchTmp = true;
+            if (cursor->passDirFilter(relDirPath, &childMightMatchTmp))
+                return true;
+            childMightMatch |= childMightMatchTmp;
+        }
+
+        if (childItemMightMatch)
+            *childItemMightMatch = childMightMatch;
+        return false;
+    }
+
+    std::unique_ptr<FolderCursor> getChildCursor(const Zstring& relDirPathPf) const override
+    {
+        std::vector<std::unique_ptr<FolderCursor>> childCursors;
+        for (const std::unique_ptr<FolderCursor>& cursor : cursors_)
+            childCursors.push_back(cursor->getChildCursor(relDirPathPf));
+
+        return std::make_unique<UnionCursor>(std::move(childCursors));
+    }
+
+private:
+    const std::vector<std::unique_ptr<FolderCursor>> cursors_;
+};
+}
+
+
+std::unique_ptr<HardFilter::FolderCursor> HardFilter::getBaseCursor() const { return std::make_unique<PathCursor>(*this); }
+
+
+std::unique_ptr<HardFilter::FolderCursor> CombinedFilter::getBaseCursor() const
+{
+    return std::make_unique<CombinedCursor>(first_.getBaseCursor(), second_.getBaseCursor());
+}
+
+
+std::unique_ptr<HardFilter::FolderCursor> UnionFilter::getBaseCursor() const
+{
+    std::vector<std::unique_ptr<FolderCursor>> cursors;
+    for (const FilterRef& filter : filters_)
+        cursors.push_back(filter->getBaseCursor());
+
+    return std::make_unique<UnionCursor>(std::move(cursors));
+}
@@ -9,6 +9,7 @@
 
 #include <vector>
 #include <memory>
+#include <algorithm>
 #include <zen/zstring.h>
 
 
@@ -24,9 +25,9 @@ Semantics of HardFilter:
 
            HardFilter (interface)
                /|\
-       _________|_____________
-      |         |             |
-NullFilter  NameFilter  CombinedFilter
+       _________|____________________________
+      |         |             |              |
+NullFilter  NameFilter  CombinedFilter  UnionFilter
 */
 
 class HardFilter //interface for filtering
@@ -46,6 +47,21 @@ public:
 
     virtual FilterRef copyFilterAddingExclusion(const Zstring& excludePhrase) const = 0;
 
+    //incremental filtering while traversing: the folder path is matched once, child items only need to match their name
+    class FolderCursor //immutable => thread-safe
+    {
+    public:
+        virtual ~FolderCursor() {}
+
+        //same results as HardFilter, but relative paths must be children of this cursor's folder
+        virtual bool passFileFilter(const Zstring& relFilePath) const = 0;
+        virtual bool passDirFilter (const Zstring& relDirPath, bool* childItemMightMatch) const = 0;
+
+        virtual std::unique_ptr<FolderCursor> getChildCursor(const Zstring& relDirPathPf /*postfixed with FILE_NAME_SEPARATOR!*/) const = 0;
+    };
+    //cursor for the base folder (empty relative path); default: evaluate full paths
+    virtual std::unique_ptr<FolderCursor> getBaseCursor() const;
+
 private:
     friend bool operator<(const HardFilter& lhs, const HardFilter& rhs);
 
@@ -88,14 +104,22 @@ public:
     bool isNull() const override;
     static bool isNull(const Zstring& includePhrase, const Zstring& excludePhrase); //*fast* check without expensive NameFilter construction!
     FilterRef copyFilterAddingExclusion(const Zstring& excludePhrase) const override;
+    std::unique_ptr<FolderCursor> getBaseCursor() const override;
 
 private:
     bool cmpLessSameType(const HardFilter& other) const override;
 
+    class Cursor;
+    bool passFileFilter(const Zstring& relFilePath,                           const Cursor* parentCursor /*optional*/) const;
+    bool passDirFilter (const Zstring& relDirPath, bool* childItemMightMatch, const Cursor* parentCursor /*optional*/) const;
+
     std::vector<Zstring> includeMasksFileFolder; //
     std::vector<Zstring> includeMasksFolder;     //upper case (windows) + unique items by construction
     std::vector<Zstring> excludeMasksFileFolder; //
     std::vector<Zstring> excludeMasksFolder;     //
+
+    struct CompiledMasks;
+    std::shared_ptr<const CompiledMasks> compiledMasks; //mask lists above compiled into combined matchers; immutable => shared by copies
 };
 
 
@@ -108,6 +132,7 @@ public:
     bool passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const override;
     bool isNull() const override;
     FilterRef copyFilterAddingExclusion(const Zstring& excludePhrase) const override;
+    std::unique_ptr<FolderCursor> getBaseCursor() const override;
 
 private:
     bool cmpLessSameType(const HardFilter& other) const override;
@@ -116,6 +141,23 @@ private:
     const NameFilter second_;
 };
 
+class UnionFilter : public HardFilter  //match if at least one filter matches: e.g. traverse a folder once for multiple filters
+{
+public:
+    explicit UnionFilter(const std::vector<FilterRef>& filters) : filters_(filters) { assert(filters_.size() >= 2); }
+
+    bool passFileFilter(const Zstring& relFilePath) const override;
+    bool passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const override;
+    bool isNull() const override;
+    FilterRef copyFilterAddingExclusion(const Zstring& excludePhrase) const override;
+    std::unique_ptr<FolderCursor> getBaseCursor() const override;
+
+private:
+    bool cmpLessSameType(const HardFilter& other) const override;
+
+    const std::vector<FilterRef> filters_; //all bound
+};
+
 const Zchar FILTER_ITEM_SEPARATOR = Zstr('|');
 
 
@@ -211,6 +253,62 @@ bool CombinedFilter::cmpLessSameType(const HardFilter& other) const
 }
 
 
+inline
+bool UnionFilter::passFileFilter(const Zstring& relFilePath) const
+{
+    return std::any_of(filters_.begin(), filters_.end(), [&](const FilterRef& filter) { return filter->passFileFilter(relFilePath); });
+}
+
+
+inline
+bool UnionFilter::passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const
+{
+    bool childMightMatch = false;
+    for (const FilterRef& filter : filters_)
+    {
+        bool childMightMatchTmp = true;
+        if (filter->passDirFilter(relDirPath, &childMightMatchTmp))
+            return true;
+        childMightMatch |= childMightMatchTmp;
+    }
+
+    if (childItemMightMatch)
+        *childItemMightMatch = childMightMatch;
+    return false;
+}
+
+
+inline
+bool UnionFilter::isNull() const
+{
+    return std::any_of(filters_.begin(), filters_.end(), [](const FilterRef& filter) { return filter->isNull(); });
+}
+
+
+inline
+HardFilter::FilterRef UnionFilter::copyFilterAddingExclusion(const Zstring& excludePhrase) const
+{
+    std::vector<FilterRef> filtersTmp;
+    for (const FilterRef& filter : filters_)
+        filtersTmp.push_back(filter->copyFilterAddingExclusion(excludePhrase));
+
+    return std::make_shared<UnionFilter>(filtersTmp);
+}
+
+
+inline
+bool UnionFilter::cmpLessSameType(const HardFilter& other) const
+{
+    assert(typeid(*this) == typeid(other)); //always given in this context!
+
+    const UnionFilter& otherUnionFilt = static_cast<const UnionFilter&>(other);
+
+    return std::lexicographical_compare(filters_.begin(), filters_.end(),
+                                        otherUnionFilt.filters_.begin(), otherUnionFilt.filters_.end(),
+    [](const FilterRef& lhs, const FilterRef& rhs) { return *lhs < *rhs; });
+}
+
+
 inline
 HardFilter::FilterRef constructFilter(const Zstring& includePhrase,
                                       const Zstring& excludePhrase,
@@ -0,0 +1,62 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "hash_cache.h"
+#include "db_file.h"
+
+using namespace zen;
+using namespace fff;
+
+
+namespace
+{
+//-------------------------------------------------------------------------------------------------------------------------------
+const Zchar HASH_CACHE_NAME[] = Zstr("ContentHash");
+const int HASH_CACHE_FORMAT = 2; //since 2026-10-17
+//-------------------------------------------------------------------------------------------------------------------------------
+
+/*------------------------------------------------------------------------------
+  | ensure 32/64 bit portability: use fixed size data types only e.g. uint32_t |
+  ------------------------------------------------------------------------------*/
+}
+
+
+ContentHashes fff::loadContentHashes(const AbstractPath& baseFolderPath, const std::function<void(const std::wstring& statusMsg)>& notifyStatus) //throw FileError
+{
+    ContentHashes output;
+    loadFolderCacheFile(baseFolderPath, HASH_CACHE_NAME, HASH_CACHE_FORMAT, [&](MemoryStreamIn<ByteArray>& streamIn) //throw FileError
+    {
+        size_t hashCount = readNumber<uint32_t>(streamIn); //throw UnexpectedEndOfStreamError
+        while (hashCount-- != 0)
+        {
+            ContentHashKey key;
+            key.fileId   = readContainer<AFS::FileId>(streamIn); //throw UnexpectedEndOfStreamError
+            key.fileSize = readNumber<uint64_t>(streamIn);       //
+            key.modTime  = readNumber<int64_t >(streamIn);       //
+            const uint64_t digest = readNumber<uint64_t>(streamIn); //
+
+            output.emplace_hint(output.end(), std::move(key), digest); //stream is ordered by key
+        }
+    }, notifyStatus);
+    return output;
+}
+
+
+void fff::saveContentHashes(const AbstractPath& baseFolderPath, const ContentHashes& hashes, //throw FileError
+                            const std::function<void(const std::wstring& statusMsg)>& notifyStatus)
+{
+    saveFolderCacheFile(baseFolderPath, HASH_CACHE_NAME, HASH_CACHE_FORMAT, [&](MemoryStreamOut<ByteArray>& streamOut) //throw FileError
+    {
+        writeNumber<uint32_t>(streamOut, static_cast<uint32_t>(hashes.size()));
+        for (const auto& [key, digest] : hashes)
+        {
+            writeContainer<AFS::FileId>(streamOut, key.fileId);
+            writeNumber<uint64_t>(streamOut, key.fileSize);
+            writeNumber<int64_t >(streamOut, key.modTime);
+            writeNumber<uint64_t>(streamOut, digest);
+        }
+    }, notifyStatus);
+}
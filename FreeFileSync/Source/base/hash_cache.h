@@ -0,0 +1,47 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef HASH_CACHE_H_2349857234095872340
+#define HASH_CACHE_H_2349857234095872340
+
+#include <map>
+#include "../fs/abstract.h"
+
+
+namespace fff
+{
+/*
+persistent content hashes for CompareVariant::CONTENT_CACHED: one file per base folder, stored in config directory
+    - only hashes of files found equal by a byte-by-byte comparison are cached
+    - a hash stays valid as long as file id, size and modification time are unchanged
+    - files without file id (e.g. FTP) are not cached
+*/
+struct ContentHashKey
+{
+    AbstractFileSystem::FileId fileId;
+    uint64_t fileSize = 0;
+    time_t modTime = 0;
+};
+inline bool operator<(const ContentHashKey& lhs, const ContentHashKey& rhs)
+{
+    if (lhs.fileSize != rhs.fileSize) //cheap checks first
+        return lhs.fileSize < rhs.fileSize;
+    if (lhs.modTime != rhs.modTime)
+        return lhs.modTime < rhs.modTime;
+    return lhs.fileId < rhs.fileId;
+}
+
+using ContentHashes = std::map<ContentHashKey, uint64_t /*XXH64, see getFileContentDigest()*/>;
+
+//call from main thread only: see getConfigDirPathPf()
+ContentHashes loadContentHashes(const AbstractPath& baseFolderPath, //throw FileError; empty if not yet existing
+                                const std::function<void(const std::wstring& statusMsg)>& notifyStatus);
+
+void saveContentHashes(const AbstractPath& baseFolderPath, const ContentHashes& hashes, //throw FileError
+                       const std::function<void(const std::wstring& statusMsg)>& notifyStatus);
+}
+
+#endif //HASH_CACHE_H_2349857234095872340
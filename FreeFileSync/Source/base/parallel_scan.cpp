@@ -6,6 +6,7 @@
 
 #include "parallel_scan.h"
 #include <chrono>
+#include <exception>
 #include <zen/file_error.h>
 #include <zen/basic_math.h>
 #include <zen/thread.h>
@@ -181,8 +182,17 @@ public:
         return rv;
     }
 
+    //context of worker thread
+    void notifyFolderRead(const DirectoryKey& folderKey)
+    {
+        assert(!runningMainThread());
+        std::lock_guard<std::mutex> dummy(lockRequest_);
+        foldersRead_.push_back(folderKey);
+        conditionNewRequest.notify_all();
+    }
+
     //context of main thread
-    void waitUntilDone(std::chrono::milliseconds duration, const TravErrorCb& onError, const TravStatusCb& onStatusUpdate) //throw X
+    void waitUntilDone(std::chrono::milliseconds duration, const TravErrorCb& onError, const TravStatusCb& onStatusUpdate, const TravFolderCb& onFolderRead) //throw X
     {
         assert(runningMainThread());
         for (;;)
@@ -191,7 +201,7 @@ public:
 
             for (std::unique_lock<std::mutex> dummy(lockRequest_) ;;) //process all errors without delay
             {
-                const bool rv = conditionNewRequest.wait_until(dummy, callbackTime, [this] { return (errorRequest_ && !errorResponse_) || (threadsToFinish_ == 0); });
+                const bool rv = conditionNewRequest.wait_until(dummy, callbackTime, [this] { return (errorRequest_ && !errorResponse_) || !foldersRead_.empty() || (threadsToFinish_ == 0); });
                 if (!rv) //time-out + condition not met
                     break;
 
@@ -201,6 +211,17 @@ public:
                     errorResponse_ = onError(errorRequest_->first, errorRequest_->second); //throw X
                     conditionHaveResponse_.notify_all(); //instead of notify_one(); workaround bug: https://svn.boost.org/trac/boost/ticket/7796
                 }
+                if (!foldersRead_.empty()) //worker threads continue scanning meanwhile: call outside of mutex scope
+                {
+                    std::vector<DirectoryKey> foldersRead;
+                    foldersRead.swap(foldersRead_);
+
+                    dummy.unlock();
+                    for (const DirectoryKey& folderKey : foldersRead)
+                        onFolderRead(folderKey); //throw X
+                    dummy.lock();
+                    continue; //re-check errorRequest_: onFolderRead() may have taken a while
+                }
                 if (threadsToFinish_ == 0)
                 {
                     dummy.unlock();
@@ -296,6 +317,7 @@ private:
     std::condition_variable conditionHaveResponse_;
     std::optional<std::pair<std::wstring, size_t>>     errorRequest_; //error message + retry number
     std::optional<AFS::TraverserCallback::HandleError> errorResponse_;
+    std::vector<DirectoryKey> foldersRead_; //traversal completed, but not yet reported to main thread
     size_t threadsToFinish_; //can't use activeThreadIdxs_.size() which is locked by different mutex!
     //also note: activeThreadIdxs_.size() may be 0 during worker thread construction!
 
@@ -322,6 +344,9 @@ struct TraverserConfig
     std::map<Zstring, std::wstring, LessFilePath>& failedDirReads;
     std::map<Zstring, std::wstring, LessFilePath>& failedItemReads;
 
+    const FolderListings* const prevListings; //optional: incremental traversal
+    FolderListings&             folderListings;
+
     AsyncCallback& acb;
     const int threadIdx;
     std::chrono::steady_clock::time_point& lastReportTime; //thread-level
@@ -331,14 +356,16 @@ struct TraverserConfig
 class DirCallback : public AFS::TraverserCallback
 {
 public:
-    DirCallback(TraverserConfig& cfg,
+    DirCallback(const std::shared_ptr<TraverserConfig>& cfg, //shared by all callbacks of a base folder: released when its traversal is complete
                 const Zstring& parentRelPathPf, //postfixed with FILE_NAME_SEPARATOR!
+                std::unique_ptr<HardFilter::FolderCursor>&& filterCursor, //state of cfg.filter for parentRelPathPf
                 FolderContainer& output,
                 int level) :
         cfg_(cfg),
         parentRelPathPf_(parentRelPathPf),
+        filterCursor_(std::move(filterCursor)),
         output_(output),
-        level_(level) {} //MUST NOT use cfg_ during construction! see BaseDirCallback()
+        level_(level) {}
 
     virtual void                               onFile   (const AFS::FileInfo&    fi) override; //
     virtual std::shared_ptr<TraverserCallback> onFolder (const AFS::FolderInfo&  fi) override; //throw ThreadInterruption
@@ -347,11 +374,18 @@ public:
     HandleError reportDirError (const std::wstring& msg, size_t retryNumber)                          override { return reportError(msg, retryNumber, Zstring()); } //throw ThreadInterruption
     HandleError reportItemError(const std::wstring& msg, size_t retryNumber, const Zstring& itemName) override { return reportError(msg, retryNumber, itemName);  } //
 
+    bool                      wantFolderListing() override { return cfg_->prevListings != nullptr; }
+    const AFS::FolderListing* getFolderListing () override;
+    void                      onFolderListing  (const AFS::FolderListing& listing) override { cfg_->folderListings[getFolderRelPath()] = listing; }
+
 private:
     HandleError reportError(const std::wstring& msg, size_t retryNumber, const Zstring& itemName /*optional*/); //throw ThreadInterruption
 
-    TraverserConfig& cfg_;
+    Zstring getFolderRelPath() const { return beforeLast(parentRelPathPf_, FILE_NAME_SEPARATOR, IF_MISSING_RETURN_NONE); }
+
+    const std::shared_ptr<TraverserConfig> cfg_;
     const Zstring parentRelPathPf_;
+    const std::unique_ptr<HardFilter::FolderCursor> filterCursor_; //match child items by name only
     FolderContainer& output_;
     const int level_;
 };
@@ -360,27 +394,12 @@ private:
 class BaseDirCallback : public DirCallback
 {
 public:
-    BaseDirCallback(const DirectoryKey& baseFolderKey, DirectoryValue& output,
-                    AsyncCallback& acb, int threadIdx, std::chrono::steady_clock::time_point& lastReportTime) :
-        DirCallback(travCfg_ /*not yet constructed!!!*/, Zstring(), output.folderCont, 0 /*level*/),
-        travCfg_
+    BaseDirCallback(const std::shared_ptr<TraverserConfig>& cfg, FolderContainer& output) :
+        DirCallback(cfg, Zstring(), cfg->filter->getBaseCursor(), output, 0 /*level*/)
     {
-        baseFolderKey.folderPath,
-        baseFolderKey.filter,
-        baseFolderKey.handleSymlinks,
-        output.failedFolderReads,
-        output.failedItemReads,
-        acb,
-        threadIdx,
-        lastReportTime
+        if (cfg->acb.mayReportCurrentFile(cfg->threadIdx, cfg->lastReportTime))
+            cfg->acb.reportCurrentFile(AFS::getDisplayPath(cfg->baseFolderPath)); //just in case first directory access is blocking
     }
-    {
-        if (acb.mayReportCurrentFile(threadIdx, lastReportTime))
-            acb.reportCurrentFile(AFS::getDisplayPath(baseFolderKey.folderPath)); //just in case first directory access is blocking
-    }
-
-private:
-    TraverserConfig travCfg_;
 };
 
 
@@ -391,12 +410,12 @@ void DirCallback::onFile(const AFS::FileInfo& fi) //throw ThreadInterruption
     const Zstring fileRelPath = parentRelPathPf_ + fi.itemName;
 
     //update status information no matter whether item is excluded or not!
-    if (cfg_.acb.mayReportCurrentFile(cfg_.threadIdx, cfg_.lastReportTime))
-        cfg_.acb.reportCurrentFile(AFS::getDisplayPath(AFS::appendRelPath(cfg_.baseFolderPath, fileRelPath)));
+    if (cfg_->acb.mayReportCurrentFile(cfg_->threadIdx, cfg_->lastReportTime))
+        cfg_->acb.reportCurrentFile(AFS::getDisplayPath(AFS::appendRelPath(cfg_->baseFolderPath, fileRelPath)));
 
     //------------------------------------------------------------------------------------
     //apply filter before processing (use relative name!)
-    if (!cfg_.filter->passFileFilter(fileRelPath))
+    if (!filterCursor_->passFileFilter(fileRelPath))
         return;
 
     //sync.ffs_db database and lock files are excluded via filter!
@@ -414,7 +433,7 @@ void DirCallback::onFile(const AFS::FileInfo& fi) //throw ThreadInterruption
 
     output_.addSubFile(fi.itemName, FileAttributes(fi.modTime, fi.fileSize, fi.fileId, fi.symlinkInfo != nullptr));
 
-    cfg_.acb.incItemsScanned(); //add 1 element to the progress indicator
+    cfg_->acb.incItemsScanned(); //add 1 element to the progress indicator
 }
 
 
@@ -425,26 +444,26 @@ std::shared_ptr<AFS::TraverserCallback> DirCallback::onFolder(const AFS::FolderI
     const Zstring& folderRelPath = parentRelPathPf_ + fi.itemName;
 
     //update status information no matter whether item is excluded or not!
-    if (cfg_.acb.mayReportCurrentFile(cfg_.threadIdx, cfg_.lastReportTime))
-        cfg_.acb.reportCurrentFile(AFS::getDisplayPath(AFS::appendRelPath(cfg_.baseFolderPath, folderRelPath)));
+    if (cfg_->acb.mayReportCurrentFile(cfg_->threadIdx, cfg_->lastReportTime))
+        cfg_->acb.reportCurrentFile(AFS::getDisplayPath(AFS::appendRelPath(cfg_->baseFolderPath, folderRelPath)));
 
     //------------------------------------------------------------------------------------
     //apply filter before processing (use relative name!)
     bool childItemMightMatch = true;
-    const bool passFilter = cfg_.filter->passDirFilter(folderRelPath, &childItemMightMatch);
+    const bool passFilter = filterCursor_->passDirFilter(folderRelPath, &childItemMightMatch);
     if (!passFilter && !childItemMightMatch)
         return nullptr; //do NOT traverse subdirs
     //else: attention! ensure directory filtering is applied later to exclude actually filtered directories
 
     FolderContainer& subFolder = output_.addSubFolder(fi.itemName, fi.symlinkInfo != nullptr);
     if (passFilter)
-        cfg_.acb.incItemsScanned(); //add 1 element to the progress indicator
+        cfg_->acb.incItemsScanned(); //add 1 element to the progress indicator
 
     //------------------------------------------------------------------------------------
     if (level_ > 100) //Win32 traverser: stack overflow approximately at level 1000
         //check after FolderContainer::addSubFolder()
         for (size_t retryNumber = 0;; ++retryNumber)
-            switch (reportItemError(replaceCpy(_("Cannot read directory %x."), L"%x", AFS::getDisplayPath(AFS::appendRelPath(cfg_.baseFolderPath, folderRelPath))) +
+            switch (reportItemError(replaceCpy(_("Cannot read directory %x."), L"%x", AFS::getDisplayPath(AFS::appendRelPath(cfg_->baseFolderPath, folderRelPath))) +
                                     L"\n\n" L"Endless recursion.", retryNumber, fi.itemName)) //throw ThreadInterruption
             {
                 case AbstractFileSystem::TraverserCallback::ON_ERROR_RETRY:
@@ -453,7 +472,8 @@ std::shared_ptr<AFS::TraverserCallback> DirCallback::onFolder(const AFS::FolderI
                     return nullptr;
             }
 
-    return std::make_shared<DirCallback>(cfg_, folderRelPath + FILE_NAME_SEPARATOR, subFolder, level_ + 1);
+    const Zstring& folderRelPathPf = folderRelPath + FILE_NAME_SEPARATOR;
+    return std::make_shared<DirCallback>(cfg_, folderRelPathPf, filterCursor_->getChildCursor(folderRelPathPf), subFolder, level_ + 1);
 }
 
 
@@ -464,29 +484,29 @@ DirCallback::HandleLink DirCallback::onSymlink(const AFS::SymlinkInfo& si) //thr
     const Zstring& linkRelPath = parentRelPathPf_ + si.itemName;
 
     //update status information no matter whether item is excluded or not!
-    if (cfg_.acb.mayReportCurrentFile(cfg_.threadIdx, cfg_.lastReportTime))
-        cfg_.acb.reportCurrentFile(AFS::getDisplayPath(AFS::appendRelPath(cfg_.baseFolderPath, linkRelPath)));
+    if (cfg_->acb.mayReportCurrentFile(cfg_->threadIdx, cfg_->lastReportTime))
+        cfg_->acb.reportCurrentFile(AFS::getDisplayPath(AFS::appendRelPath(cfg_->baseFolderPath, linkRelPath)));
 
-    switch (cfg_.handleSymlinks)
+    switch (cfg_->handleSymlinks)
     {
         case SymLinkHandling::EXCLUDE:
             return LINK_SKIP;
 
         case SymLinkHandling::DIRECT:
-            if (cfg_.filter->passFileFilter(linkRelPath)) //always use file filter: Link type may not be "stable" on Linux!
+            if (filterCursor_->passFileFilter(linkRelPath)) //always use file filter: Link type may not be "stable" on Linux!
             {
                 output_.addSubLink(si.itemName, LinkAttributes(si.modTime));
-                cfg_.acb.incItemsScanned(); //add 1 element to the progress indicator
+                cfg_->acb.incItemsScanned(); //add 1 element to the progress indicator
             }
             return LINK_SKIP;
 
         case SymLinkHandling::FOLLOW:
             //filter symlinks before trying to follow them: handle user-excluded broken symlinks!
             //since we don't know yet what type the symlink will resolve to, only do this when both filter variants agree:
-            if (!cfg_.filter->passFileFilter(linkRelPath))
+            if (!filterCursor_->passFileFilter(linkRelPath))
             {
                 bool childItemMightMatch = true;
-                if (!cfg_.filter->passDirFilter(linkRelPath, &childItemMightMatch))
+                if (!filterCursor_->passDirFilter(linkRelPath, &childItemMightMatch))
                     if (!childItemMightMatch)
                         return LINK_SKIP;
             }
@@ -498,15 +518,27 @@ DirCallback::HandleLink DirCallback::onSymlink(const AFS::SymlinkInfo& si) //thr
 }
 
 
+const AFS::FolderListing* DirCallback::getFolderListing()
+{
+    if (cfg_->prevListings)
+    {
+        auto it = cfg_->prevListings->find(getFolderRelPath());
+        if (it != cfg_->prevListings->end())
+            return &it->second;
+    }
+    return nullptr;
+}
+
+
 DirCallback::HandleError DirCallback::reportError(const std::wstring& msg, size_t retryNumber, const Zstring& itemName /*optional*/) //throw ThreadInterruption
 {
-    switch (cfg_.acb.reportError(msg, retryNumber)) //throw ThreadInterruption
+    switch (cfg_->acb.reportError(msg, retryNumber)) //throw ThreadInterruption
     {
         case ON_ERROR_CONTINUE:
             if (itemName.empty())
-                cfg_.failedDirReads.emplace(beforeLast(parentRelPathPf_, FILE_NAME_SEPARATOR, IF_MISSING_RETURN_NONE), msg);
+                cfg_->failedDirReads.emplace(getFolderRelPath(), msg);
             else
-                cfg_.failedItemReads.emplace(parentRelPathPf_ + itemName, msg);
+                cfg_->failedItemReads.emplace(parentRelPathPf_ + itemName, msg);
             return ON_ERROR_CONTINUE;
 
         case ON_ERROR_RETRY:
@@ -518,11 +550,84 @@ DirCallback::HandleError DirCallback::reportError(const std::wstring& msg, size_
 }
 
 
-void fff::parallelDeviceTraversal(const std::set<DirectoryKey>& foldersToRead,
-                                  std::map<DirectoryKey, DirectoryValue>& output,
-                                  const std::map<AbstractPath, size_t>& deviceParallelOps,
-                                  const TravErrorCb& onError, const TravStatusCb& onStatusUpdate,
-                                  std::chrono::milliseconds cbInterval)
+namespace
+{
+//would a traversal with this filter enter the folder? folderRelPath is empty for the base folder
+bool filterEntersFolder(const HardFilter& filter, const Zstring& folderRelPath)
+{
+    Zstring parentRelPathPf;
+    for (const Zstring& folderName : split(folderRelPath, FILE_NAME_SEPARATOR, SplitType::SKIP_EMPTY))
+    {
+        const Zstring relPath = parentRelPathPf + folderName;
+
+        bool childItemMightMatch = true;
+        if (!filter.passDirFilter(relPath, &childItemMightMatch) && !childItemMightMatch)
+            return false;
+
+        parentRelPathPf = relPath + FILE_NAME_SEPARATOR;
+    }
+    return true;
+}
+
+
+//apply one of the filters of a UnionFilter traversal in memory: same result as traversing with this filter (harmonize with DirCallback!)
+void deriveFolderContent(const FolderContainer& folderCont, const Zstring& parentRelPathPf, const HardFilter::FolderCursor& filterCursor, FolderContainer& output) //throw ThreadInterruption
+{
+    interruptionPoint(); //throw ThreadInterruption
+
+    for (const auto& [fileName, attr] : folderCont.files)
+        if (filterCursor.passFileFilter(parentRelPathPf + fileName))
+            output.addSubFile(fileName, attr); //same order => output is frozen already
+
+    for (const auto& [linkName, attr] : folderCont.symlinks) //SymLinkHandling::DIRECT
+        if (filterCursor.passFileFilter(parentRelPathPf + linkName))
+            output.addSubLink(linkName, attr);
+
+    for (const auto& [folderName, attrAndCont] : folderCont.folders)
+    {
+        const Zstring folderRelPath = parentRelPathPf + folderName;
+
+        bool childItemMightMatch = true;
+        if (filterCursor.passDirFilter(folderRelPath, &childItemMightMatch) || childItemMightMatch)
+        {
+            const Zstring& folderRelPathPf = folderRelPath + FILE_NAME_SEPARATOR;
+            deriveFolderContent(*attrAndCont.second, folderRelPathPf, *filterCursor.getChildCursor(folderRelPathPf),
+                                output.addSubFolder(folderName, attrAndCont.first)); //recurse
+        }
+    }
+}
+
+
+void deriveDirectoryValue(const DirectoryValue& dirValue, const HardFilter& filter, DirectoryValue& output) //throw ThreadInterruption
+{
+    deriveFolderContent(dirValue.folderCont, Zstring(), *filter.getBaseCursor(), output.folderCont); //throw ThreadInterruption
+
+    for (const auto& [folderRelPath, msg] : dirValue.failedFolderReads)
+        if (filterEntersFolder(filter, folderRelPath))
+            output.failedFolderReads.emplace(folderRelPath, msg);
+
+    for (const auto& [itemRelPath, msg] : dirValue.failedItemReads) //item errors are reported *before* the item is filtered: see DirCallback
+        if (filterEntersFolder(filter, beforeLast(itemRelPath, FILE_NAME_SEPARATOR, IF_MISSING_RETURN_NONE)))
+            output.failedItemReads.emplace(itemRelPath, msg);
+}
+
+
+struct FolderTraversal
+{
+    DirectoryKey travKey; //multiple outputs: UnionFilter of all their filters
+    std::vector<std::pair<DirectoryKey, DirectoryValue*>> outputs;
+    const FolderListings* prevListings; //optional; immutable during traversal
+};
+}
+
+
+std::map<AbstractPath, size_t> fff::parallelDeviceTraversal(const std::set<DirectoryKey>& foldersToRead,
+                                                            std::map<DirectoryKey, DirectoryValue>& output,
+                                                            const std::map<AbstractPath, FolderListings>& prevListings,
+                                                            const std::map<AbstractPath, size_t>& deviceParallelOps,
+                                                            size_t adaptiveParallelOpsMax,
+                                                            const TravErrorCb& onError, const TravStatusCb& onStatusUpdate, const TravFolderCb& onFolderRead,
+                                                            std::chrono::milliseconds cbInterval)
 {
     output.clear();
 
@@ -535,6 +640,12 @@ void fff::parallelDeviceTraversal(const std::set<DirectoryKey>& foldersToRead,
     for (const DirectoryKey& key : foldersToRead)
         perDeviceFolders[AFS::getRootPath(key.folderPath)].insert(key);
 
+    //adaptive mode: one limit per device
+    std::map<AbstractPath, std::unique_ptr<AdaptiveConcurrencyLimit>> deviceParallelOpsLimits; //manage life time: enclose InterruptibleThread's!!!
+    if (adaptiveParallelOpsMax > 0)
+        for (const auto& [rootPath, folderKeys] : perDeviceFolders)
+            deviceParallelOpsLimits.emplace(rootPath, std::make_unique<AdaptiveConcurrencyLimit>(getDeviceParallelOps(deviceParallelOps, rootPath), adaptiveParallelOpsMax));
+
     //communication channel used by threads
     AsyncCallback acb(perDeviceFolders.size() /*threadsToFinish*/, cbInterval); //manage life time: enclose InterruptibleThread's!!!
 
@@ -547,14 +658,34 @@ void fff::parallelDeviceTraversal(const std::set<DirectoryKey>& foldersToRead,
     {
         const AbstractPath& rootPath = item.first;
         const int threadIdx = static_cast<int>(worker.size());
-        const size_t parallelOps = getDeviceParallelOps(deviceParallelOps, rootPath);
+        AdaptiveConcurrencyLimit* const parallelOpsLimit = adaptiveParallelOpsMax > 0 ? deviceParallelOpsLimits.find(rootPath)->second.get() : nullptr;
+        const size_t parallelOps = parallelOpsLimit ? parallelOpsLimit->getLimitMax() : getDeviceParallelOps(deviceParallelOps, rootPath);
 
-        std::map<DirectoryKey, DirectoryValue*> workload;
+        //same base folder, but different filters (e.g. multiple folder pairs rooted in the same share): traverse only once
+        std::vector<FolderTraversal> workload;
 
-        for (const DirectoryKey& key : item.second)
-            workload.emplace(key, &output[key]); //=> DirectoryValue* unshared for lock-free worker-thread access
+        for (const DirectoryKey& key : item.second) //ordered by handleSymlinks, folderPath, filter
+        {
+            if (workload.empty() ||
+                workload.back().travKey.handleSymlinks != key.handleSymlinks ||
+                AFS::compareAbstractPath(workload.back().travKey.folderPath, key.folderPath) != 0)
+            {
+                auto itPrev = prevListings.find(key.folderPath);
+                workload.push_back({ key, {}, itPrev != prevListings.end() ? &itPrev->second : nullptr });
+            }
+            workload.back().outputs.emplace_back(key, &output[key]); //=> DirectoryValue* unshared for lock-free worker-thread access
+        }
+
+        for (FolderTraversal& ft : workload)
+            if (ft.outputs.size() > 1)
+            {
+                std::vector<HardFilter::FilterRef> filters;
+                for (const auto& [folderKey, dirValue] : ft.outputs)
+                    filters.push_back(folderKey.filter);
+                ft.travKey.filter = std::make_shared<UnionFilter>(filters);
+            }
 
-        worker.emplace_back([rootPath, workload, threadIdx, &acb, parallelOps]() mutable
+        worker.emplace_back([rootPath, workload, threadIdx, &acb, parallelOps, parallelOpsLimit]() mutable
         {
             setCurrentThreadName(("Comp Worker[" + numberTo<std::string>(threadIdx) + "]").c_str());
 
@@ -563,17 +694,70 @@ void fff::parallelDeviceTraversal(const std::set<DirectoryKey>& foldersToRead,
 
             std::chrono::steady_clock::time_point lastReportTime; //keep thread-local!
 
-            AFS::TraverserWorkload travWorkload;
+            auto finishTraversal = [&](const FolderTraversal& ft, DirectoryValue& travValue) //throw ThreadInterruption
+            {
+                travValue.folderCont.freeze();
+
+                if (&travValue != ft.outputs[0].second)
+                {
+                    for (const auto& [folderKey, dirValue] : ft.outputs)
+                        deriveDirectoryValue(travValue, *folderKey.filter, *dirValue); //throw ThreadInterruption
 
-            for (auto& wl : workload)
+                    ft.outputs[0].second->folderListings = std::move(travValue.folderListings); //listings don't depend on the filter
+                }
+
+                for (const auto& [folderKey, dirValue] : ft.outputs)
+                    acb.notifyFolderRead(folderKey); //*dirValue no longer accessed by this thread
+            };
+
+            std::vector<DirectoryValue> travValuesShared(workload.size()); //UnionFilter traversals: derive outputs when done
+            AFS::TraverserWorkload travWorkload; //lifetime: enclosed by finishTraversal and travValuesShared
+
+            //traverse all base folders concurrently, but report each one as soon as it is complete: the main thread can start processing
+            //it while the remaining ones are still being scanned (see ComparisonBuffer)
+            for (size_t i = 0; i < workload.size(); ++i)
             {
-                const std::vector<Zstring> relPath = split(AFS::getRootRelativePath(wl.first.folderPath), FILE_NAME_SEPARATOR, SplitType::SKIP_EMPTY);
-                assert(AFS::getRootPath(wl.first.folderPath) == rootPath);
-                travWorkload.emplace_back(relPath, std::make_shared<BaseDirCallback>(wl.first, *wl.second, acb, threadIdx, lastReportTime));
+                const FolderTraversal& ft = workload[i];
+                DirectoryValue& travValue = ft.outputs.size() == 1 ? *ft.outputs[0].second : travValuesShared[i];
+                assert(AFS::getRootPath(ft.travKey.folderPath) == rootPath);
+
+                //shared by all DirCallbacks of this base folder: traverser releases them as soon as their folder is done => last one = traversal complete
+                std::shared_ptr<TraverserConfig> travCfg(new TraverserConfig
+                {
+                    ft.travKey.folderPath,
+                    ft.travKey.filter,
+                    ft.travKey.handleSymlinks,
+                    travValue.failedFolderReads,
+                    travValue.failedItemReads,
+                    ft.prevListings,
+                    travValue.folderListings,
+                    acb,
+                    threadIdx,
+                    lastReportTime
+                }, [&finishTraversal, &ft, &travValue](TraverserConfig* cfg)
+                {
+                    delete cfg;
+                    if (std::uncaught_exceptions() == 0) //else: traversal aborted
+                        try
+                        {
+                            finishTraversal(ft, travValue); //throw ThreadInterruption
+                        }
+                        catch (ThreadInterruption&) {} //interruption status is kept: see interruptionPoint() below
+                });
+
+                travWorkload.emplace_back(split(AFS::getRootRelativePath(ft.travKey.folderPath), FILE_NAME_SEPARATOR, SplitType::SKIP_EMPTY),
+                                          std::make_shared<BaseDirCallback>(travCfg, travValue.folderCont));
             }
-            AFS::traverseFolderRecursive(rootPath, travWorkload, parallelOps); //throw ThreadInterruption
+
+            AFS::traverseFolderRecursive(rootPath, std::move(travWorkload), parallelOps, parallelOpsLimit); //throw ThreadInterruption
+            interruptionPoint(); //throw ThreadInterruption
         });
     }
 
-    acb.waitUntilDone(cbInterval, onError, onStatusUpdate); //throw X
+    acb.waitUntilDone(cbInterval, onError, onStatusUpdate, onFolderRead); //throw X
+
+    std::map<AbstractPath, size_t> adaptedParallelOps;
+    for (const auto& [rootPath, parallelOpsLimit] : deviceParallelOpsLimits)
+        adaptedParallelOps.emplace(rootPath, parallelOpsLimit->getBestLimit());
+    return adaptedParallelOps;
 }
@@ -13,6 +13,7 @@
 #include "hard_filter.h"
 #include "structures.h"
 #include "file_hierarchy.h"
+#include "scan_snapshot.h"
 
 
 namespace fff
@@ -48,6 +49,8 @@ struct DirectoryValue
 
     //relative paths (never empty) for failure to read single file/dir/symlink with corresponding error message
     std::map<Zstring, std::wstring, LessFilePath> failedItemReads;
+
+    FolderListings folderListings; //incremental traversal only: listings of all folders read
 };
 
 
@@ -56,12 +59,18 @@ struct DirectoryValue
 
 using TravErrorCb  = std::function<AFS::TraverserCallback::HandleError(const std::wstring& msg,        size_t retryNumber)>;
 using TravStatusCb = std::function<                              void (const std::wstring& statusLine, int     itemsTotal)>;
-
-void parallelDeviceTraversal(const std::set<DirectoryKey>& foldersToRead,
-                             std::map<DirectoryKey, DirectoryValue>& output,
-                             const std::map<AbstractPath, size_t>& deviceParallelOps,
-                             const TravErrorCb& onError, const TravStatusCb& onStatusUpdate, //NOT optional
-                             std::chrono::milliseconds cbInterval);
+using TravFolderCb = std::function<                              void (const DirectoryKey& folderKey)>;
+
+//adaptiveParallelOpsMax > 0: tune parallel operations per device at runtime, starting with deviceParallelOps => return best values found
+//onFolderRead: context of main thread; traversal of output[folderKey] is complete while other folders may still be scanned => caller may consume (and erase) the entry
+//prevListings: incremental traversal for folder paths with an entry (possibly empty): reuse listings of unchanged folders + return current ones in DirectoryValue::folderListings
+std::map<AbstractPath, size_t> parallelDeviceTraversal(const std::set<DirectoryKey>& foldersToRead,
+                                                       std::map<DirectoryKey, DirectoryValue>& output,
+                                                       const std::map<AbstractPath, FolderListings>& prevListings,
+                                                       const std::map<AbstractPath, size_t>& deviceParallelOps,
+                                                       size_t adaptiveParallelOpsMax,
+                                                       const TravErrorCb& onError, const TravStatusCb& onStatusUpdate, const TravFolderCb& onFolderRead, //NOT optional
+                                                       std::chrono::milliseconds cbInterval);
 }
 
 #endif //PARALLEL_SCAN_H_924588904275284572857
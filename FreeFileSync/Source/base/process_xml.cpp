@@ -23,7 +23,7 @@ using namespace fff; //functionally needed for correct overload resolution!!!
 namespace
 {
 //-------------------------------------------------------------------------------------------------------------------------------
-const int XML_FORMAT_VER_GLOBAL  = 11; //2018-09-09
+const int XML_FORMAT_VER_GLOBAL  = 12; //2026-10-17
 const int XML_FORMAT_VER_FFS_CFG = 14; //2018-08-13
 //-------------------------------------------------------------------------------------------------------------------------------
 }
@@ -165,6 +165,9 @@ void writeText(const CompareVariant& value, std::string& output)
         case CompareVariant::SIZE:
             output = "Size";
             break;
+        case CompareVariant::CONTENT_CACHED:
+            output = "ContentCached";
+            break;
     }
 }
 
@@ -178,6 +181,8 @@ bool readText(const std::string& input, CompareVariant& value)
         value = CompareVariant::CONTENT;
     else if (tmp == "Size")
         value = CompareVariant::SIZE;
+    else if (tmp == "ContentCached")
+        value = CompareVariant::CONTENT_CACHED;
     else
         return false;
     return true;
@@ -1087,7 +1092,7 @@ void readConfig(const XmlIn& in, FilterConfig& filter, int formatVer)
 }
 
 
-void readConfig(const XmlIn& in, LocalPairConfig& lpc, std::map<AbstractPath, size_t>& deviceParallelOps, int formatVer)
+void readConfig(const XmlIn& in, LocalPairConfig& lpc, std::map<AbstractPath, size_t>& deviceParallelOps, std::map<AbstractPath, size_t>& deviceCopyBuffers, int formatVer)
 {
     //read folder pairs
     in["Left" ](lpc.folderPathPhraseLeft);
@@ -1128,6 +1133,19 @@ void readConfig(const XmlIn& in, LocalPairConfig& lpc, std::map<AbstractPath, si
     setParallelOps(lpc.folderPathPhraseLeft,  parallelOpsL);
     setParallelOps(lpc.folderPathPhraseRight, parallelOpsR);
 
+    size_t copyBuffersL = 0;
+    size_t copyBuffersR = 0;
+    if (const XmlElement* e = in["Left" ].get()) e->getAttribute("Buffers", copyBuffersL); //optional attribute
+    if (const XmlElement* e = in["Right"].get()) e->getAttribute("Buffers", copyBuffersR); //
+
+    auto setCopyBuffers = [&](const Zstring& folderPathPhrase, size_t copyBuffers)
+    {
+        const size_t copyBuffersPrev = getDeviceCopyBuffers(deviceCopyBuffers, folderPathPhrase);
+        /**/                           setDeviceCopyBuffers(deviceCopyBuffers, folderPathPhrase, std::max(copyBuffers, copyBuffersPrev));
+    };
+    setCopyBuffers(lpc.folderPathPhraseLeft,  copyBuffersL);
+    setCopyBuffers(lpc.folderPathPhraseRight, copyBuffersR);
+
     //TODO: remove after migration - 2016-07-24
     auto ciReplace = [](Zstring& pathPhrase, const Zstring& oldTerm, const Zstring& newTerm) { pathPhrase = ciReplaceCpy(pathPhrase, oldTerm, newTerm); };
     ciReplace(lpc.folderPathPhraseLeft,  Zstr("%csidl_MyDocuments%"), Zstr("%csidl_Documents%"));
@@ -1215,7 +1233,7 @@ void readConfig(const XmlIn& in, MainConfiguration& mainCfg, int formatVer)
     for (XmlIn inPair = inMain["FolderPairs"]["Pair"]; inPair; inPair.next())
     {
         LocalPairConfig lpc;
-        readConfig(inPair, lpc, mainCfg.deviceParallelOps, formatVer);
+        readConfig(inPair, lpc, mainCfg.deviceParallelOps, mainCfg.deviceCopyBuffers, formatVer);
 
         if (firstItem)
         {
@@ -1393,6 +1411,19 @@ void readConfig(const XmlIn& in, XmlGlobalSettings& cfg, int formatVer)
     inGeneral["Language"].attribute("Name", cfg.programLanguage);
 
     inGeneral["FailSafeFileCopy"         ].attribute("Enabled", cfg.failSafeFileCopy);
+    if (formatVer >= 12) //TODO: remove if check after migration! 2026-10-17
+    {
+        inGeneral["CacheNeutralFileCopy"].attribute("Enabled",          cfg.cacheNeutralFileCopy);
+        inGeneral["CacheNeutralFileCopy"].attribute("DirectIoMinSizeMB", cfg.directIoMinSizeMB);
+        inGeneral["ChunkedFileCopy"     ].attribute("MinSizeMB",         cfg.chunkedCopyMinSizeMB);
+        inGeneral["AsyncFileIo"         ].attribute("Enabled",           cfg.asyncFileIo);
+        inGeneral["AdaptiveParallelOps" ].attribute("Enabled",           cfg.adaptiveParallelOps);
+        inGeneral["AdaptiveParallelOps" ].attribute("MaxOps",            cfg.adaptiveParallelOpsMax);
+        inGeneral["IncrementalScan"     ].attribute("Enabled",           cfg.incrementalScan);
+        inGeneral["IncrementalScan"     ].attribute("FullRescanInterval", cfg.incrementalScanFullRescanInterval);
+        inGeneral["DetectMovedFilesByContent"].attribute("Enabled",   cfg.detectMovedFilesByContent);
+        inGeneral["DetectMovedFilesByContent"].attribute("MinSizeMB", cfg.detectMovedFilesByContentMinSizeMB);
+    }
     inGeneral["CopyLockedFiles"          ].attribute("Enabled", cfg.copyLockedFiles);
     inGeneral["CopyFilePermissions"      ].attribute("Enabled", cfg.copyFilePermissions);
     inGeneral["FileTimeTolerance"        ].attribute("Seconds", cfg.fileTimeTolerance);
@@ -1923,7 +1954,7 @@ void writeConfig(const FilterConfig& filter, XmlOut& out)
 }
 
 
-void writeConfig(const LocalPairConfig& lpc, const std::map<AbstractPath, size_t>& deviceParallelOps, XmlOut& out)
+void writeConfig(const LocalPairConfig& lpc, const std::map<AbstractPath, size_t>& deviceParallelOps, const std::map<AbstractPath, size_t>& deviceCopyBuffers, XmlOut& out)
 {
     XmlOut outPair = out.ref().addChild("Pair");
 
@@ -1940,6 +1971,12 @@ void writeConfig(const LocalPairConfig& lpc, const std::map<AbstractPath, size_t
     //avoid "fake" changed configs by only storing "real" parallel-enabled devices in deviceParallelOps
     assert(std::all_of(deviceParallelOps.begin(), deviceParallelOps.end(), [](const auto& item) { return item.second > 1; }));
 
+    const size_t copyBuffersL = getDeviceCopyBuffers(deviceCopyBuffers, lpc.folderPathPhraseLeft);
+    const size_t copyBuffersR = getDeviceCopyBuffers(deviceCopyBuffers, lpc.folderPathPhraseRight);
+
+    if (copyBuffersL > 1) outPair["Left" ].attribute("Buffers", copyBuffersL);
+    if (copyBuffersR > 1) outPair["Right"].attribute("Buffers", copyBuffersR);
+
     //###########################################################
     //alternate comp configuration (optional)
     if (lpc.localCmpCfg)
@@ -1986,10 +2023,10 @@ void writeConfig(const MainConfiguration& mainCfg, XmlOut& out)
     //###########################################################
     XmlOut outFp = outMain["FolderPairs"];
     //write folder pairs
-    writeConfig(mainCfg.firstPair, mainCfg.deviceParallelOps, outFp);
+    writeConfig(mainCfg.firstPair, mainCfg.deviceParallelOps, mainCfg.deviceCopyBuffers, outFp);
 
     for (const LocalPairConfig& lpc : mainCfg.additionalPairs)
-        writeConfig(lpc, mainCfg.deviceParallelOps, outFp);
+        writeConfig(lpc, mainCfg.deviceParallelOps, mainCfg.deviceCopyBuffers, outFp);
 
     outMain["Errors"].attribute("Ignore", mainCfg.ignoreErrors);
     outMain["Errors"].attribute("Retry",  mainCfg.automaticRetryCount);
@@ -2038,6 +2075,16 @@ void writeConfig(const XmlGlobalSettings& cfg, XmlOut& out)
     outGeneral["Language"].attribute("Name", cfg.programLanguage);
 
     outGeneral["FailSafeFileCopy"         ].attribute("Enabled", cfg.failSafeFileCopy);
+    outGeneral["CacheNeutralFileCopy"     ].attribute("Enabled",           cfg.cacheNeutralFileCopy);
+    outGeneral["CacheNeutralFileCopy"     ].attribute("DirectIoMinSizeMB", cfg.directIoMinSizeMB);
+    outGeneral["ChunkedFileCopy"          ].attribute("MinSizeMB",         cfg.chunkedCopyMinSizeMB);
+    outGeneral["AsyncFileIo"              ].attribute("Enabled",           cfg.asyncFileIo);
+    outGeneral["AdaptiveParallelOps"      ].attribute("Enabled",           cfg.adaptiveParallelOps);
+    outGeneral["AdaptiveParallelOps"      ].attribute("MaxOps",            cfg.adaptiveParallelOpsMax);
+    outGeneral["IncrementalScan"          ].attribute("Enabled",           cfg.incrementalScan);
+    outGeneral["IncrementalScan"          ].attribute("FullRescanInterval", cfg.incrementalScanFullRescanInterval);
+    outGeneral["DetectMovedFilesByContent"].attribute("Enabled",           cfg.detectMovedFilesByContent);
+    outGeneral["DetectMovedFilesByContent"].attribute("MinSizeMB",         cfg.detectMovedFilesByContentMinSizeMB);
     outGeneral["CopyLockedFiles"          ].attribute("Enabled", cfg.copyLockedFiles);
     outGeneral["CopyFilePermissions"      ].attribute("Enabled", cfg.copyFilePermissions);
     outGeneral["FileTimeTolerance"        ].attribute("Seconds", cfg.fileTimeTolerance);
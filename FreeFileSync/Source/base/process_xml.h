@@ -171,6 +171,16 @@ struct XmlGlobalSettings
     //Shared (GUI/BATCH) settings
     wxLanguage programLanguage = getSystemLanguage();
     bool failSafeFileCopy = true;
+    bool cacheNeutralFileCopy = false; //don't evict other applications' data from the page cache during bulk copies
+    size_t directIoMinSizeMB = 0;      //cache-neutral copy: bypass page cache for files of at least this size; 0: never
+    size_t chunkedCopyMinSizeMB = 0;    //copy files of at least this size using "deviceParallelOps" threads if in-kernel copy is not supported; 0: never
+    bool asyncFileIo = false;           //io_uring read-ahead/write-behind for buffered file copies (Linux 5.6+); see zen::enableAsyncFileIo()
+    bool adaptiveParallelOps = false;   //tune "deviceParallelOps" per device at runtime (AIMD), starting with the configured values
+    size_t adaptiveParallelOpsMax = 16; //
+    bool incrementalScan = false;       //reuse folder listings of the previous comparison for unchanged folders (see scan_snapshot.h)
+    size_t incrementalScanFullRescanInterval = 10; //safety net: full rescan every N-th run
+    bool detectMovedFilesByContent = false;        //pair left-only/right-only files of identical content as moved when no sync database match exists
+    size_t detectMovedFilesByContentMinSizeMB = 1; //ignore small files: not worth reading both sides to save a copy
     bool copyLockedFiles  = false; //safer default: avoid copies of partially written files
     bool copyFilePermissions = false;
 
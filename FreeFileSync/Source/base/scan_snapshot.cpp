@@ -0,0 +1,83 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "scan_snapshot.h"
+#include "db_file.h"
+
+using namespace zen;
+using namespace fff;
+
+
+namespace
+{
+//-------------------------------------------------------------------------------------------------------------------------------
+const Zchar SCAN_SNAPSHOT_NAME[] = Zstr("ScanSnapshot");
+const int SCAN_SNAPSHOT_FORMAT = 2; //since 2026-10-17
+//-------------------------------------------------------------------------------------------------------------------------------
+
+/*------------------------------------------------------------------------------
+  | ensure 32/64 bit portability: use fixed size data types only e.g. uint32_t |
+  ------------------------------------------------------------------------------*/
+
+void writeItemName(MemoryStreamOut<ByteArray>& streamOut, const Zstring& itemName) { writeContainer<std::string>(streamOut, utfTo<std::string>(itemName)); }
+Zstring readItemName(MemoryStreamIn<ByteArray>& streamIn) { return utfTo<Zstring>(readContainer<std::string>(streamIn)); } //throw UnexpectedEndOfStreamError
+}
+
+
+ScanSnapshot fff::loadScanSnapshot(const AbstractPath& baseFolderPath, const std::function<void(const std::wstring& statusMsg)>& notifyStatus) //throw FileError
+{
+    ScanSnapshot output;
+    loadFolderCacheFile(baseFolderPath, SCAN_SNAPSHOT_NAME, SCAN_SNAPSHOT_FORMAT, [&](MemoryStreamIn<ByteArray>& streamIn) //throw FileError
+    {
+        output.incrementalRuns = readNumber<uint32_t>(streamIn); //throw UnexpectedEndOfStreamError
+
+        size_t folderCount = readNumber<uint32_t>(streamIn); //throw UnexpectedEndOfStreamError
+        while (folderCount-- != 0)
+        {
+            const Zstring folderRelPath = readItemName(streamIn); //throw UnexpectedEndOfStreamError
+
+            AFS::FolderListing listing;
+            listing.changeStamp = readContainer<std::string>(streamIn); //throw UnexpectedEndOfStreamError
+
+            size_t itemCount = readNumber<uint32_t>(streamIn); //throw UnexpectedEndOfStreamError
+            while (itemCount-- != 0)
+            {
+                AFS::FolderListing::Item item;
+                item.itemName = readItemName(streamIn);           //throw UnexpectedEndOfStreamError
+                item.itemType = readNumber<uint8_t >(streamIn); //
+                item.itemId   = readNumber<uint64_t>(streamIn); //
+                listing.items.push_back(std::move(item));
+            }
+            output.folders.emplace_hint(output.folders.end(), folderRelPath, std::move(listing)); //stream is ordered by key
+        }
+    }, notifyStatus);
+    return output;
+}
+
+
+void fff::saveScanSnapshot(const AbstractPath& baseFolderPath, const ScanSnapshot& snapshot, //throw FileError
+                           const std::function<void(const std::wstring& statusMsg)>& notifyStatus)
+{
+    saveFolderCacheFile(baseFolderPath, SCAN_SNAPSHOT_NAME, SCAN_SNAPSHOT_FORMAT, [&](MemoryStreamOut<ByteArray>& streamOut) //throw FileError
+    {
+        writeNumber<uint32_t>(streamOut, static_cast<uint32_t>(snapshot.incrementalRuns));
+
+        writeNumber<uint32_t>(streamOut, static_cast<uint32_t>(snapshot.folders.size()));
+        for (const auto& [folderRelPath, listing] : snapshot.folders)
+        {
+            writeItemName(streamOut, folderRelPath);
+            writeContainer<std::string>(streamOut, listing.changeStamp);
+
+            writeNumber<uint32_t>(streamOut, static_cast<uint32_t>(listing.items.size()));
+            for (const AFS::FolderListing::Item& item : listing.items)
+            {
+                writeItemName(streamOut, item.itemName);
+                writeNumber<uint8_t >(streamOut, item.itemType);
+                writeNumber<uint64_t>(streamOut, item.itemId);
+            }
+        }
+    }, notifyStatus);
+}
@@ -0,0 +1,37 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef SCAN_SNAPSHOT_H_8340957239485723409
+#define SCAN_SNAPSHOT_H_8340957239485723409
+
+#include <map>
+#include "../fs/abstract.h"
+
+
+namespace fff
+{
+/*
+persistent folder listings for incremental rescans: one file per base folder, stored in config directory
+    - the AFS reuses a listing (and skips reading the folder) if the folder is unchanged, e.g. native: same mtime/ctime
+    - file attributes are NOT reused: modifying a file's content does not change its parent folder => items are still stat'ed
+*/
+using FolderListings = std::map<Zstring, AbstractFileSystem::FolderListing>; //key: base-relative folder path, empty for base folder
+
+struct ScanSnapshot
+{
+    size_t incrementalRuns = 0; //traversals since last full rescan
+    FolderListings folders;
+};
+
+//call from main thread only: see getConfigDirPathPf()
+ScanSnapshot loadScanSnapshot(const AbstractPath& baseFolderPath, //throw FileError; empty if not yet existing
+                              const std::function<void(const std::wstring& statusMsg)>& notifyStatus);
+
+void saveScanSnapshot(const AbstractPath& baseFolderPath, const ScanSnapshot& snapshot, //throw FileError
+                      const std::function<void(const std::wstring& statusMsg)>& notifyStatus);
+}
+
+#endif //SCAN_SNAPSHOT_H_8340957239485723409
@@ -9,6 +9,7 @@
 
 #include <zen/file_error.h>
 #include <zen/thread.h>
+#include <zen/concurrency_limit.h>
 #include "process_callback.h"
 
 
@@ -394,6 +395,7 @@ namespace
 {
 void massParallelExecute(const std::vector<std::pair<AbstractPath, ParallelWorkItem>>& workload,
                          const std::map<AbstractPath, size_t>& deviceParallelOps,
+                         size_t adaptiveParallelOpsMax, //tune deviceParallelOps at runtime up to this limit; 0: disabled
                          const std::string& threadGroupName,
                          ProcessCallback& callback /*throw X*/)
 {
@@ -405,9 +407,10 @@ void massParallelExecute(const std::vector<std::pair<AbstractPath, ParallelWorkI
 
     struct ThreadGroupContext
     {
-        ThreadGroupContext(size_t parallelOps, const std::string& groupName, size_t prio, const ParallelContext::AddTaskCallback& scheduleTask) :
-            threadGroup(parallelOps, groupName), statusPrio(prio), scheduleExtraTask(scheduleTask) {}
+        ThreadGroupContext(size_t parallelOps, std::unique_ptr<AdaptiveConcurrencyLimit>&& opsLimit, const std::string& groupName, size_t prio, const ParallelContext::AddTaskCallback& scheduleTask) :
+            parallelOpsLimit(std::move(opsLimit)), threadGroup(parallelOpsLimit ? parallelOpsLimit->getLimitMax() : parallelOps, groupName), statusPrio(prio), scheduleExtraTask(scheduleTask) {}
 
+        std::unique_ptr<AdaptiveConcurrencyLimit> parallelOpsLimit; //optional; enclose ThreadGroup!
         ThreadGroup<std::function<void()>> threadGroup;
         const size_t statusPrio = 0;
         ParallelContext::AddTaskCallback scheduleExtraTask;
@@ -440,8 +443,10 @@ void massParallelExecute(const std::vector<std::pair<AbstractPath, ParallelWorkI
 
                 ThreadGroupContext& ctx = deviceThreadGroupsPtr->find(rootPath)->second; //exists after construction above!
 
-                ctx.threadGroup.run([&acb, statusPrio = ctx.statusPrio, itemPath, task, &scheduleExtraTask = ctx.scheduleExtraTask]
+                ctx.threadGroup.run([&acb, statusPrio = ctx.statusPrio, itemPath, task, &scheduleExtraTask = ctx.scheduleExtraTask, parallelOpsLimit = ctx.parallelOpsLimit.get()]
                 {
+                    ConcurrencySlot slot(parallelOpsLimit); //throw ThreadInterruption
+
                     acb.notifyTaskBegin(statusPrio);
                     ZEN_ON_SCOPE_EXIT(acb.notifyTaskEnd());
 
@@ -451,6 +456,7 @@ void massParallelExecute(const std::vector<std::pair<AbstractPath, ParallelWorkI
             });
         };
         deviceThreadGroups.emplace(rootPath, ThreadGroupContext(parallelOps,
+                                                                adaptiveParallelOpsMax > 0 ? std::make_unique<AdaptiveConcurrencyLimit>(parallelOps, adaptiveParallelOpsMax) : nullptr,
                                                                 threadGroupName + " " + utfTo<std::string>(AFS::getDisplayPath(rootPath)),
                                                                 statusPrio,
                                                                 scheduleExtraTask));
@@ -465,8 +471,10 @@ void massParallelExecute(const std::vector<std::pair<AbstractPath, ParallelWorkI
         ThreadGroupContext& ctx = deviceThreadGroups.find(rootPath)->second; //exists after construction above!
 
         for (const std::pair<AbstractPath, ParallelWorkItem>* item : devItems.second)
-            ctx.threadGroup.run([&acb, statusPrio = ctx.statusPrio, &itemPath = item->first, &task = item->second, &scheduleExtraTask = ctx.scheduleExtraTask]
+            ctx.threadGroup.run([&acb, statusPrio = ctx.statusPrio, &itemPath = item->first, &task = item->second, &scheduleExtraTask = ctx.scheduleExtraTask, parallelOpsLimit = ctx.parallelOpsLimit.get()]
         {
+            ConcurrencySlot slot(parallelOpsLimit); //throw ThreadInterruption
+
             acb.notifyTaskBegin(statusPrio);
             ZEN_ON_SCOPE_EXIT(acb.notifyTaskEnd());
 
@@ -485,6 +493,14 @@ void massParallelExecute(const std::vector<std::pair<AbstractPath, ParallelWorkI
         acb.notifyAllDone(); //noexcept
 
     acb.waitUntilDone(UI_UPDATE_INTERVAL / 2 /*every ~50 ms*/, callback); //throw X
+
+    if (adaptiveParallelOpsMax > 0)
+    {
+        std::map<AbstractPath, size_t> adaptedParallelOps;
+        for (const auto& [rootPath, ctx] : deviceThreadGroups)
+            adaptedParallelOps.emplace(rootPath, ctx.parallelOpsLimit->getBestLimit());
+        callback.reportInfo(formatAdaptedParallelOps(adaptedParallelOps)); //throw X
+    }
 }
 }
 #ifdef __GNUC__
@@ -63,6 +63,8 @@ std::wstring fff::getVariantName(CompareVariant var)
             return _("File content");
         case CompareVariant::SIZE:
             return _("File size");
+        case CompareVariant::CONTENT_CACHED:
+            return _("File content (cached)");
     }
     assert(false);
     return _("Error");
@@ -248,6 +250,15 @@ void fff::setDeviceParallelOps(std::map<AbstractPath, size_t>& deviceParallelOps
 }
 
 
+std::wstring fff::formatAdaptedParallelOps(const std::map<AbstractPath, size_t>& adaptedParallelOps)
+{
+    std::wstring msg = _("Parallel file operations:");
+    for (const auto& [rootPath, parallelOps] : adaptedParallelOps)
+        msg += L"\n    " + AFS::getDisplayPath(rootPath) + L" - " + numberTo<std::wstring>(parallelOps);
+    return msg;
+}
+
+
 size_t fff::getDeviceParallelOps(const std::map<AbstractPath, size_t>& deviceParallelOps, const Zstring& folderPathPhrase)
 {
     return getDeviceParallelOps(deviceParallelOps, createAbstractPath(folderPathPhrase));
@@ -260,6 +271,39 @@ void fff::setDeviceParallelOps(std::map<AbstractPath, size_t>& deviceParallelOps
 }
 
 
+size_t fff::getDeviceCopyBuffers(const std::map<AbstractPath, size_t>& deviceCopyBuffers, const AbstractPath& ap)
+{
+    const AbstractPath& rootPath = AFS::getRootPath(ap);
+    auto it = deviceCopyBuffers.find(rootPath);
+    return it != deviceCopyBuffers.end() ? it->second : 0;
+}
+
+
+void fff::setDeviceCopyBuffers(std::map<AbstractPath, size_t>& deviceCopyBuffers, const AbstractPath& ap, size_t copyBuffers)
+{
+    const AbstractPath rootPath = AFS::getRootPath(ap);
+    if (!AFS::isNullPath(rootPath))
+    {
+        if (copyBuffers > 1)
+            deviceCopyBuffers[rootPath] = copyBuffers;
+        else
+            deviceCopyBuffers.erase(rootPath);
+    }
+}
+
+
+size_t fff::getDeviceCopyBuffers(const std::map<AbstractPath, size_t>& deviceCopyBuffers, const Zstring& folderPathPhrase)
+{
+    return getDeviceCopyBuffers(deviceCopyBuffers, createAbstractPath(folderPathPhrase));
+}
+
+
+void fff::setDeviceCopyBuffers(std::map<AbstractPath, size_t>& deviceCopyBuffers, const Zstring& folderPathPhrase, size_t copyBuffers)
+{
+    setDeviceCopyBuffers(deviceCopyBuffers, createAbstractPath(folderPathPhrase), copyBuffers);
+}
+
+
 std::wstring fff::getSymbol(CompareFilesResult cmpRes)
 {
     switch (cmpRes)
@@ -608,6 +652,11 @@ MainConfiguration fff::merge(const std::vector<MainConfiguration>& mainCfgs)
         for (const auto& item : mainCfg.deviceParallelOps)
             mergedParallelOps[item.first] = std::max(mergedParallelOps[item.first], item.second);
 
+    std::map<AbstractPath, size_t> mergedCopyBuffers;
+    for (const MainConfiguration& mainCfg : mainCfgs)
+        for (const auto& item : mainCfg.deviceCopyBuffers)
+            mergedCopyBuffers[item.first] = std::max(mergedCopyBuffers[item.first], item.second);
+
     //final assembly
     MainConfiguration cfgOut;
     cfgOut.cmpCfg       = cmpCfgHead;
@@ -616,6 +665,7 @@ MainConfiguration fff::merge(const std::vector<MainConfiguration>& mainCfgs)
     cfgOut.firstPair    = mergedCfgs[0];
     cfgOut.additionalPairs.assign(mergedCfgs.begin() + 1, mergedCfgs.end());
     cfgOut.deviceParallelOps = mergedParallelOps;
+    cfgOut.deviceCopyBuffers = mergedCopyBuffers;
 
     cfgOut.ignoreErrors = std::all_of(mainCfgs.begin(), mainCfgs.end(), [](const MainConfiguration& mainCfg) { return mainCfg.ignoreErrors; });
 
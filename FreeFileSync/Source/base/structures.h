@@ -22,7 +22,8 @@ enum class CompareVariant
 {
     TIME_SIZE,
     CONTENT,
-    SIZE
+    SIZE,
+    CONTENT_CACHED, //CONTENT, but skip reading files whose hash is known: see hash_cache.h
 };
 
 std::wstring getVariantName(CompareVariant var);
@@ -51,7 +52,7 @@ enum CompareFilesResult
     FILE_RIGHT_SIDE_ONLY,
     FILE_LEFT_NEWER,  //CompareVariant::TIME_SIZE only!
     FILE_RIGHT_NEWER, //
-    FILE_DIFFERENT_CONTENT, //CompareVariant::CONTENT, CompareVariant::SIZE only!
+    FILE_DIFFERENT_CONTENT, //CompareVariant::CONTENT(_CACHED), CompareVariant::SIZE only!
     FILE_DIFFERENT_METADATA, //both sides equal, but different metadata only: short name case
     FILE_CONFLICT
 };
@@ -113,7 +114,7 @@ struct DirectionSet
     SyncDirection exRightSideOnly = SyncDirection::LEFT;
     SyncDirection leftNewer       = SyncDirection::RIGHT; //CompareVariant::TIME_SIZE only!
     SyncDirection rightNewer      = SyncDirection::LEFT;  //
-    SyncDirection different       = SyncDirection::NONE; //CompareVariant::CONTENT, CompareVariant::SIZE only!
+    SyncDirection different       = SyncDirection::NONE; //CompareVariant::CONTENT(_CACHED), CompareVariant::SIZE only!
     SyncDirection conflict        = SyncDirection::NONE;
 };
 
@@ -404,6 +405,7 @@ struct MainConfiguration
     std::vector<LocalPairConfig> additionalPairs;
 
     std::map<AbstractPath /*device root*/, size_t /*parallel operations*/> deviceParallelOps; //should only include devices with >= 2  parallel ops
+    std::map<AbstractPath /*device root*/, size_t /*copy buffers*/       > deviceCopyBuffers; //should only include devices with >= 2  buffers (= pipelined file copy)
 
     bool ignoreErrors = false; //true: errors will still be logged
     size_t automaticRetryCount = 0;
@@ -423,6 +425,15 @@ void   setDeviceParallelOps(      std::map<AbstractPath, size_t>& deviceParallel
 size_t getDeviceParallelOps(const std::map<AbstractPath, size_t>& deviceParallelOps, const Zstring& folderPathPhrase);
 void   setDeviceParallelOps(      std::map<AbstractPath, size_t>& deviceParallelOps, const Zstring& folderPathPhrase, size_t parallelOps);
 
+//adaptive parallel operations: report values found at runtime => user may take them over into the configuration
+std::wstring formatAdaptedParallelOps(const std::map<AbstractPath, size_t>& adaptedParallelOps);
+
+//0 or 1: no pipelining (read and write in turn)
+size_t getDeviceCopyBuffers(const std::map<AbstractPath, size_t>& deviceCopyBuffers, const AbstractPath& ap);
+void   setDeviceCopyBuffers(      std::map<AbstractPath, size_t>& deviceCopyBuffers, const AbstractPath& ap, size_t copyBuffers);
+size_t getDeviceCopyBuffers(const std::map<AbstractPath, size_t>& deviceCopyBuffers, const Zstring& folderPathPhrase);
+void   setDeviceCopyBuffers(      std::map<AbstractPath, size_t>& deviceCopyBuffers, const Zstring& folderPathPhrase, size_t copyBuffers);
+
 
 inline
 bool operator==(const MainConfiguration& lhs, const MainConfiguration& rhs)
@@ -433,6 +444,7 @@ bool operator==(const MainConfiguration& lhs, const MainConfiguration& rhs)
            lhs.firstPair           == rhs.firstPair           &&
            lhs.additionalPairs     == rhs.additionalPairs     &&
            lhs.deviceParallelOps   == rhs.deviceParallelOps   &&
+           lhs.deviceCopyBuffers   == rhs.deviceCopyBuffers   &&
            lhs.ignoreErrors        == rhs.ignoreErrors        &&
            lhs.automaticRetryCount == rhs.automaticRetryCount &&
            lhs.automaticRetryDelay == rhs.automaticRetryDelay &&
@@ -20,7 +20,7 @@
 #include "../fs/native.h"
 
     #include <unistd.h> //fsync
-    #include <fcntl.h>  //open
+    #include <fcntl.h>  //open, posix_fadvise
 
 using namespace zen;
 using namespace fff;
@@ -447,19 +447,25 @@ void flushFileBuffers(const Zstring& nativeFilePath) //throw FileError
 
     if (::fsync(fileHandle) != 0)
         THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(nativeFilePath)), L"fsync");
+
+    //pages are clean after fsync => drop them, so that verification reads what is actually on disk
+    /*int rv =*/ ::posix_fadvise(fileHandle, 0 /*offset*/, 0 /*len: until end of file*/, POSIX_FADV_DONTNEED); //best effort
 }
 
 
-void verifyFiles(const AbstractPath& sourcePath, const AbstractPath& targetPath, const IOCallback& notifyUnbufferedIO) //throw FileError
+//sourceDigest: content hash calculated by a buffered copy (see FileCopyOptions::computeDigest) => only the target needs to be read again
+void verifyFiles(const AbstractPath& sourcePath, const AbstractPath& targetPath, const std::optional<uint64_t>& sourceDigest, //throw FileError
+                 const IOCallback& notifyUnbufferedIO)
 {
     try
     {
-        //do like "copy /v": 1. flush target file buffers, 2. read again as usual (using OS buffers)
-        // => it seems OS buffers are not invalidated by this: snake oil???
+        //do like "copy /v": 1. flush target file buffers, 2. read again
         if (std::optional<Zstring> nativeTargetPath = AFS::getNativeItemPath(targetPath))
             flushFileBuffers(*nativeTargetPath); //throw FileError
 
-        if (!filesHaveSameContent(sourcePath, targetPath, notifyUnbufferedIO)) //throw FileError
+        if (sourceDigest ?
+            getFileContentDigest(targetPath, notifyUnbufferedIO) != *sourceDigest : //throw FileError
+            !filesHaveSameContent(sourcePath, targetPath, notifyUnbufferedIO)) //throw FileError
             throw FileError(replaceCpy(replaceCpy(_("%x and %y have different content."),
                                                   L"%x", L"\n" + fmtPath(AFS::getDisplayPath(sourcePath))),
                                        L"%y", L"\n" + fmtPath(AFS::getDisplayPath(targetPath))));
@@ -532,13 +538,14 @@ AFS::FileCopyResult copyFileTransactional(const AbstractPath& apSource, const AF
                                           const AbstractPath& apTarget,
                                           bool copyFilePermissions,
                                           bool transactionalCopy,
+                                          const FileCopyOptions& copyOptions,
                                           const std::function<void()>& onDeleteTargetFile,
                                           const IOCallback& notifyUnbufferedIO,
                                           std::mutex& singleThread)
 {
     return parallelScope([=]
     {
-        return AFS::copyFileTransactional(apSource, attrSource, apTarget, copyFilePermissions, transactionalCopy, onDeleteTargetFile, notifyUnbufferedIO); //throw FileError, ErrorFileLocked
+        return AFS::copyFileTransactional(apSource, attrSource, apTarget, copyFilePermissions, transactionalCopy, copyOptions, onDeleteTargetFile, notifyUnbufferedIO); //throw FileError, ErrorFileLocked
     }, singleThread);
 }
 
@@ -564,8 +571,8 @@ void revisionFolder(FileVersioner& versioner,
 { parallelScope([=, &versioner] { versioner.revisionFolder(folderPath, relativePath, onBeforeFileMove, onBeforeFolderMove, notifyUnbufferedIO); /*throw FileError*/ }, singleThread); }
 
 inline
-void verifyFiles(const AbstractPath& apSource, const AbstractPath& apTarget, const IOCallback& notifyUnbufferedIO, std::mutex& singleThread) //throw FileError
-{ parallelScope([=] { ::verifyFiles(apSource, apTarget, notifyUnbufferedIO); /*throw FileError*/ }, singleThread); }
+void verifyFiles(const AbstractPath& apSource, const AbstractPath& apTarget, const std::optional<uint64_t>& sourceDigest, const IOCallback& notifyUnbufferedIO, std::mutex& singleThread) //throw FileError
+{ parallelScope([=] { ::verifyFiles(apSource, apTarget, sourceDigest, notifyUnbufferedIO); /*throw FileError*/ }, singleThread); }
 
 }
 
@@ -921,10 +928,13 @@ public:
         bool verifyCopiedFiles;
         bool copyFilePermissions;
         bool failSafeFileCopy;
+        FileCopyOptions copyOptions;
         std::vector<FileError>& errorsModTime;
         DeletionHandler& delHandlerLeft;
         DeletionHandler& delHandlerRight;
         size_t threadCount;
+        AdaptiveConcurrencyLimit* parallelOpsLimitLeft;  //optional: per device, threadCount is then the upper limit
+        AdaptiveConcurrencyLimit* parallelOpsLimitRight; //optional: nullptr if same device as left
     };
 
     static void runSync(SyncCtx& syncCtx, BaseFolderPair& baseFolder, ProcessCallback& cb)
@@ -951,6 +961,7 @@ private:
         verifyCopiedFiles_  (syncCtx.verifyCopiedFiles),
         copyFilePermissions_(syncCtx.copyFilePermissions),
         failSafeFileCopy_   (syncCtx.failSafeFileCopy),
+        copyOptions_        (syncCtx.copyOptions),
         singleThread_(singleThread),
         acb_(acb) {}
 
@@ -1003,6 +1014,7 @@ private:
     const bool verifyCopiedFiles_;
     const bool copyFilePermissions_;
     const bool failSafeFileCopy_;
+    const FileCopyOptions copyOptions_;
 
     std::mutex& singleThread_;
     AsyncCallback& acb_;
@@ -1060,12 +1072,15 @@ void FolderPairSyncer::runPass(PassNo pass, SyncCtx& syncCtx, BaseFolderPair& ba
     ZEN_ON_SCOPE_EXIT( for (InterruptibleThread& wt : worker) wt.interrupt(); ); //interrupt all first, then join
 
     for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
-        worker.emplace_back([threadIdx, &singleThread, &acb, &workload]
+        worker.emplace_back([threadIdx, &singleThread, &acb, &workload, &syncCtx]
     {
         setCurrentThreadName(("Sync Worker[" + numberTo<std::string>(threadIdx) + "]").c_str());
 
         while (/*blocking call:*/ std::function<void()> workItem = workload.getNext(threadIdx)) //throw ThreadInterruption
         {
+            ConcurrencySlot slotL(syncCtx.parallelOpsLimitLeft ); //throw ThreadInterruption
+            ConcurrencySlot slotR(syncCtx.parallelOpsLimitRight); //same order for all workers => no deadlock
+
             acb.notifyTaskBegin(0 /*prio*/); //same prio, while processing only one folder pair at a time
             ZEN_ON_SCOPE_EXIT(acb.notifyTaskEnd());
 
@@ -2070,7 +2085,8 @@ AFS::FileCopyResult FolderPairSyncer::copyFileWithCallback(const FileDescriptor&
         const AFS::FileCopyResult result = parallel::copyFileTransactional(sourcePathTmp, sourceAttr, //throw FileError, ErrorFileLocked
                                                                            targetPath,
                                                                            copyFilePermissions_,
-                                                                           failSafeFileCopy_, [&]
+                                                                           failSafeFileCopy_,
+                                                                           copyOptions_, [&]
         {
             if (onDeleteTargetFile) //running *outside* singleThread_ lock! => onDeleteTargetFile-callback expects lock being held:
             {
@@ -2096,7 +2112,7 @@ AFS::FileCopyResult FolderPairSyncer::copyFileWithCallback(const FileDescriptor&
             //callback runs *outside* singleThread_ lock! => fine
             auto verifyCallback = [&](int64_t bytesDelta) { interruptionPoint(); }; //throw ThreadInterruption
 
-            parallel::verifyFiles(sourcePathTmp, targetPath, verifyCallback, singleThread_); //throw FileError
+            parallel::verifyFiles(sourcePathTmp, targetPath, result.contentDigest, verifyCallback, singleThread_); //throw FileError
         }
         //#################### /Verification #############################
 
@@ -2205,11 +2221,16 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
                       bool copyLockedFiles,
                       bool copyFilePermissions,
                       bool failSafeFileCopy,
+                      bool cacheNeutralFileCopy,
+                      uint64_t directIoMinSize,
+                      uint64_t chunkedCopyMinSize,
                       bool runWithBackgroundPriority,
                       std::chrono::seconds folderAccessTimeout,
                       const std::vector<FolderPairSyncCfg>& syncConfig,
                       FolderComparison& folderCmp,
                       const std::map<AbstractPath, size_t>& deviceParallelOps,
+                      size_t adaptiveParallelOpsMax,
+                      const std::map<AbstractPath, size_t>& deviceCopyBuffers,
                       WarningDialogs& warnings,
                       ProcessCallback& callback)
 {
@@ -2657,15 +2678,51 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
                 if (folderPairCfg.handleDeletion == DeletionPolicy::VERSIONING)
                     parallelOps = std::max(parallelOps, getDeviceParallelOps(deviceParallelOps, versioningFolderPath));
 
+                FileCopyOptions copyOptions;
+                copyOptions.cacheNeutral    = cacheNeutralFileCopy;
+                copyOptions.directIoMinSize = directIoMinSize;
+                if (chunkedCopyMinSize > 0)
+                {
+                    copyOptions.chunkedCopyThreads = parallelOps;
+                    copyOptions.chunkedCopyMinSize = chunkedCopyMinSize;
+                    copyOptions.chunkedCopyThreadBudget = std::make_shared<std::atomic<size_t>>(parallelOps); //parallel file copies share the device's budget: not parallelOps^2 threads
+                }
+                copyOptions.pipelineBuffers = std::max(getDeviceCopyBuffers(deviceCopyBuffers, baseFolder.getAbstractPath<LEFT_SIDE >()),
+                                                       getDeviceCopyBuffers(deviceCopyBuffers, baseFolder.getAbstractPath<RIGHT_SIDE>()));
+                copyOptions.computeDigest = verifyCopiedFiles; //verification: buffered copy => read target only; native copy => compare source and target
+
+                //adaptive mode: one limit per device, shared by all passes of this folder pair
+                const AbstractPath rootPathL = AFS::getRootPath(baseFolder.getAbstractPath<LEFT_SIDE >());
+                const AbstractPath rootPathR = AFS::getRootPath(baseFolder.getAbstractPath<RIGHT_SIDE>());
+                std::optional<AdaptiveConcurrencyLimit> parallelOpsLimitL;
+                std::optional<AdaptiveConcurrencyLimit> parallelOpsLimitR;
+                if (adaptiveParallelOpsMax > 0)
+                {
+                    parallelOpsLimitL.emplace(getDeviceParallelOps(deviceParallelOps, rootPathL), adaptiveParallelOpsMax);
+                    if (rootPathR != rootPathL)
+                        parallelOpsLimitR.emplace(getDeviceParallelOps(deviceParallelOps, rootPathR), adaptiveParallelOpsMax);
+                }
+
                 FolderPairSyncer::SyncCtx syncCtx =
                 {
-                    verifyCopiedFiles, copyPermissionsFp, failSafeFileCopy,
+                    verifyCopiedFiles, copyPermissionsFp, failSafeFileCopy, copyOptions,
                     errorsModTime,
                     delHandlerL, delHandlerR,
-                    parallelOps
+                    parallelOpsLimitL ? parallelOpsLimitL->getLimitMax() : parallelOps,
+                    parallelOpsLimitL ? &*parallelOpsLimitL : nullptr,
+                    parallelOpsLimitR ? &*parallelOpsLimitR : nullptr
                 };
                 FolderPairSyncer::runSync(syncCtx, baseFolder, callback);
 
+                if (parallelOpsLimitL)
+                {
+                    std::map<AbstractPath, size_t> adaptedParallelOps;
+                    adaptedParallelOps[rootPathL] = parallelOpsLimitL->getBestLimit();
+                    if (parallelOpsLimitR)
+                        adaptedParallelOps[rootPathR] = parallelOpsLimitR->getBestLimit();
+                    callback.reportInfo(formatAdaptedParallelOps(adaptedParallelOps)); //throw X
+                }
+
                 //(try to gracefully) cleanup temporary Recycle Bin folders and versioning -> will be done in ~DeletionHandler anyway...
                 tryReportingError([&] { delHandlerL.tryCleanup(callback, true /*allowCallbackException*/); /*throw FileError*/}, callback); //throw X
                 tryReportingError([&] { delHandlerR.tryCleanup(callback, true                           ); /*throw FileError*/}, callback); //throw X
@@ -2699,7 +2756,7 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
 
         //-----------------------------------------------------------------------------------------------------
 
-        applyVersioningLimit(versionLimitFolders, folderAccessTimeout, deviceParallelOps, callback); //throw X
+        applyVersioningLimit(versionLimitFolders, folderAccessTimeout, deviceParallelOps, adaptiveParallelOpsMax, callback); //throw X
 
         //------------------- show warnings after end of synchronization --------------------------------------
 
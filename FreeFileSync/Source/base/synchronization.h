@@ -91,11 +91,16 @@ void synchronize(const std::chrono::system_clock::time_point& syncStartTime,
                  bool copyLockedFiles,
                  bool copyFilePermissions,
                  bool failSafeFileCopy,
+                 bool cacheNeutralFileCopy,
+                 uint64_t directIoMinSize, //cache-neutral copy: bypass page cache for files of at least this size; 0: never
+                 uint64_t chunkedCopyMinSize, //copy files of at least this size in parallel ranges (if deviceParallelOps > 1 and no in-kernel copy); 0: never
                  bool runWithBackgroundPriority,
                  std::chrono::seconds folderAccessTimeout,
                  const std::vector<FolderPairSyncCfg>& syncConfig, //CONTRACT: syncConfig and folderCmp correspond row-wise!
                  FolderComparison& folderCmp,                      //
                  const std::map<AbstractPath, size_t>& deviceParallelOps,
+                 size_t adaptiveParallelOpsMax, //tune deviceParallelOps at runtime up to this limit; 0: disabled
+                 const std::map<AbstractPath, size_t>& deviceCopyBuffers,
                  WarningDialogs& warnings,
                  ProcessCallback& callback);
 }
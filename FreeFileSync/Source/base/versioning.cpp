@@ -220,7 +220,7 @@ void FileVersioner::revisionFileImpl(const FileDescriptor& fileDescr, const Zstr
         /*const AFS::FileCopyResult result =*/ AFS::copyFileTransactional(filePath, fileAttr, targetPath, //throw FileError, ErrorFileLocked
                                                                           false, //copyFilePermissions
                                                                           false,  //transactionalCopy: not needed for versioning! partial copy will be overwritten next time
-                                                                          nullptr /*onDeleteTargetFile*/, notifyUnbufferedIO);
+                                                                          FileCopyOptions(), nullptr /*onDeleteTargetFile*/, notifyUnbufferedIO);
         //result.errorModTime? => irrelevant for versioning!
     });
 }
@@ -364,7 +364,7 @@ void findFileVersions(VersionInfoMap& versions,
             const time_t versionTime = fff::impl::parseVersionedFolderName(folderName);
             if (versionTime != 0)
             {
-                findFileVersions(versions, item.second.second,
+                findFileVersions(versions, *item.second.second,
                                  AFS::appendRelPath(parentFolderPath, folderName),
                                  Zstring(), //[!] skip time-stamped folder
                                  &versionTime);
@@ -372,7 +372,7 @@ void findFileVersions(VersionInfoMap& versions,
             }
         }
 
-        findFileVersions(versions, item.second.second,
+        findFileVersions(versions, *item.second.second,
                          AFS::appendRelPath(parentFolderPath, folderName),
                          AFS::appendPaths(relPathOrigParent, folderName, FILE_NAME_SEPARATOR),
                          versionTimeParent);
@@ -388,7 +388,7 @@ void getFolderItemCount(std::map<AbstractPath, size_t>& folderItemCount, const F
     //e.g. "subfolder" for versioning folders c:\folder and c:\folder\subfolder
 
     for (const auto& item : folderCont.folders)
-        getFolderItemCount(folderItemCount, item.second.second, AFS::appendRelPath(parentFolderPath, item.first));
+        getFolderItemCount(folderItemCount, *item.second.second, AFS::appendRelPath(parentFolderPath, item.first));
 }
 }
 
@@ -415,6 +415,7 @@ bool fff::operator<(const VersioningLimitFolder& lhs, const VersioningLimitFolde
 void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& limitFolders,
                                std::chrono::seconds folderAccessTimeout,
                                const std::map<AbstractPath, size_t>& deviceParallelOps,
+                               size_t adaptiveParallelOpsMax,
                                ProcessCallback& callback /*throw X*/)
 {
     //--------- determine existing folder paths for traversal ---------
@@ -475,10 +476,13 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& limitFolde
         callback.reportStatus(textScanning + statusLine); //throw X
     };
 
-    parallelDeviceTraversal(foldersToRead, folderBuf,
-                            deviceParallelOps,
-                            onError, onStatusUpdate, //throw X
-                            UI_UPDATE_INTERVAL / 2); //every ~50 ms
+    const std::map<AbstractPath, size_t> adaptedParallelOps = parallelDeviceTraversal(foldersToRead, folderBuf, {} /*prevListings*/,
+                                                                                      deviceParallelOps,
+                                                                                      adaptiveParallelOpsMax,
+                                                                                      onError, onStatusUpdate, [](const DirectoryKey& folderKey) {}, //throw X
+                                                                                      UI_UPDATE_INTERVAL / 2); //every ~50 ms
+    if (!adaptedParallelOps.empty())
+        callback.reportInfo(formatAdaptedParallelOps(adaptedParallelOps)); //throw X
 
     //--------- group versions per (original) relative path ---------
     std::map<AbstractPath, VersionInfoMap> versionDetails; //versioningFolderPath => <version details>
@@ -610,5 +614,5 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& limitFolde
         warn_static("get rid of scheduleExtraTask and recursively delete parent folders!? need scheduleExtraTask for something else?")
     });
 
-    massParallelExecute(parallelWorkload, deviceParallelOps, "Versioning Limit", callback /*throw X*/);
+    massParallelExecute(parallelWorkload, deviceParallelOps, adaptiveParallelOpsMax, "Versioning Limit", callback /*throw X*/);
 }
@@ -105,6 +105,7 @@ bool operator<(const VersioningLimitFolder& lhs, const VersioningLimitFolder& rh
 void applyVersioningLimit(const std::set<VersioningLimitFolder>& limitFolders,
                           std::chrono::seconds folderAccessTimeout,
                           const std::map<AbstractPath, size_t>& deviceParallelOps,
+                          size_t adaptiveParallelOpsMax,
                           ProcessCallback& callback /*throw X*/);
 
 
@@ -8,6 +8,7 @@
 #include <zen/serialize.h>
 #include <zen/guid.h>
 #include <zen/crc.h>
+#include <zen/xxhash.h>
 
 using namespace zen;
 using namespace fff;
@@ -62,10 +63,10 @@ std::optional<AfsPath> AFS::getParentAfsPath(const AfsPath& afsPath)
 }
 
 
-void AFS::traverseFolderRecursive(const AbstractPath& basePath, const AFS::TraverserWorkload& workload, size_t parallelOps)
+void AFS::traverseFolderRecursive(const AbstractPath& basePath, AFS::TraverserWorkload&& workload, size_t parallelOps, AdaptiveConcurrencyLimit* parallelOpsLimit)
 {
     TraverserWorkloadImpl wlImpl;
-    for (const auto& item : workload)
+    for (auto& item : workload)
     {
         AfsPath afsPath = basePath.afsPath;
         for (const Zstring& itemName : item.first)
@@ -75,9 +76,9 @@ void AFS::traverseFolderRecursive(const AbstractPath& basePath, const AFS::Trave
                 afsPath.value += FILE_NAME_SEPARATOR;
             afsPath.value += itemName;
         }
-        wlImpl.emplace_back(afsPath, item.second);
+        wlImpl.emplace_back(afsPath, std::move(item.second)); //don't hold on to callbacks: see callback life time
     }
-    basePath.afs->traverseFolderRecursive(wlImpl, parallelOps); //throw
+    basePath.afs->traverseFolderRecursive(std::move(wlImpl), parallelOps, parallelOpsLimit); //throw
 }
 
 
@@ -113,17 +114,21 @@ void AFS::traverseFolderFlat(const AfsPath& afsPath, //throw FileError
                              const std::function<void (const SymlinkInfo& si)>& onSymlink) const
 {
     auto ft = std::make_shared<FlatTraverserCallback>(onFile, onFolder, onSymlink); //throw FileError
-    traverseFolderRecursive({{ afsPath, ft }}, 1 /*parallelOps*/); //throw FileError
+    traverseFolderRecursive({{ afsPath, ft }}, 1 /*parallelOps*/, nullptr /*parallelOpsLimit*/); //throw FileError
 }
 
 
 //target existing: undefined behavior! (fail/overwrite/auto-rename)
 AFS::FileCopyResult AFS::copyFileAsStream(const AfsPath& afsPathSource, const StreamAttributes& attrSource, //throw FileError, ErrorFileLocked
-                                          const AbstractPath& apTarget, const IOCallback& notifyUnbufferedIO) const
+                                          const AbstractPath& apTarget, const FileCopyOptions& copyOptions, const IOCallback& notifyUnbufferedIO) const
 {
     int64_t totalUnbufferedIO = 0;
 
-    auto streamIn = getInputStream(afsPathSource, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //throw FileError, ErrorFileLocked, X
+    const bool pipelinedCopy = copyOptions.pipelineBuffers >= 2;
+    IOCallbackAsync notifyReadAsync(IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //pipelined copy: InputStream::read() runs on worker thread
+
+    auto streamIn = getInputStream(afsPathSource, pipelinedCopy ? notifyReadAsync.getCallback() : //throw FileError, ErrorFileLocked, X
+                                   IOCallback(IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)));
 
     StreamAttributes attrSourceNew = {};
     //try to get the most current attributes if possible (input file might have changed after comparison!)
@@ -136,7 +141,24 @@ AFS::FileCopyResult AFS::copyFileAsStream(const AfsPath& afsPathSource, const St
     //target existing: undefined behavior! (fail/overwrite/auto-rename)
     auto streamOut = getOutputStream(apTarget, &attrSourceNew.fileSize, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //throw FileError
 
-    bufferedStreamCopy(*streamIn, *streamOut); //throw FileError, ErrorFileLocked, X
+    auto streamCopy = [&](auto& streamOutAny)
+    {
+        if (pipelinedCopy)
+            bufferedStreamCopyPipelined(*streamIn, streamOutAny, copyOptions.pipelineBuffers, [&] { notifyReadAsync.flush(); /*throw X*/ }); //throw FileError, ErrorFileLocked, X
+        else
+            bufferedStreamCopy(*streamIn, streamOutAny); //throw FileError, ErrorFileLocked, X
+    };
+
+    std::optional<uint64_t> contentDigest;
+    if (copyOptions.computeDigest)
+    {
+        XxHash64 hasher;
+        HashingStreamOut hashingOut(*streamOut, hasher);
+        streamCopy(hashingOut); //throw FileError, ErrorFileLocked, X
+        contentDigest = hasher.finalize();
+    }
+    else
+        streamCopy(*streamOut); //throw FileError, ErrorFileLocked, X
 
     const AFS::FileId targetFileId = streamOut->finalize(); //throw FileError, X
 
@@ -179,6 +201,7 @@ AFS::FileCopyResult AFS::copyFileAsStream(const AfsPath& afsPathSource, const St
     result.sourceFileId = attrSourceNew.fileId;
     result.targetFileId = targetFileId;
     result.errorModTime = errorModTime;
+    result.contentDigest = contentDigest;
     return result;
 }
 
@@ -188,6 +211,7 @@ AFS::FileCopyResult AFS::copyFileTransactional(const AbstractPath& apSource, con
                                                const AbstractPath& apTarget,
                                                bool copyFilePermissions,
                                                bool transactionalCopy,
+                                               const FileCopyOptions& copyOptions,
                                                const std::function<void()>& onDeleteTargetFile,
                                                const IOCallback& notifyUnbufferedIO)
 {
@@ -196,7 +220,7 @@ AFS::FileCopyResult AFS::copyFileTransactional(const AbstractPath& apSource, con
         //caveat: typeid returns static type for pointers, dynamic type for references!!!
         if (typeid(*apSource.afs) == typeid(*apTargetTmp.afs))
             return apSource.afs->copyFileForSameAfsType(apSource.afsPath, attrSource,
-                                                        apTargetTmp, copyFilePermissions, notifyUnbufferedIO); //throw FileError, ErrorFileLocked
+                                                        apTargetTmp, copyFilePermissions, copyOptions, notifyUnbufferedIO); //throw FileError, ErrorFileLocked
         //target existing: undefined behavior! (fail/overwrite/auto-rename)
 
         //fall back to stream-based file copy:
@@ -204,7 +228,7 @@ AFS::FileCopyResult AFS::copyFileTransactional(const AbstractPath& apSource, con
             throw FileError(replaceCpy(_("Cannot write permissions of %x."), L"%x", fmtPath(AFS::getDisplayPath(apTargetTmp))),
                             _("Operation not supported for different base folder types."));
 
-        return apSource.afs->copyFileAsStream(apSource.afsPath, attrSource, apTargetTmp, notifyUnbufferedIO); //throw FileError, ErrorFileLocked
+        return apSource.afs->copyFileAsStream(apSource.afsPath, attrSource, apTargetTmp, copyOptions, notifyUnbufferedIO); //throw FileError, ErrorFileLocked
         //target existing: undefined behavior! (fail/overwrite/auto-rename)
     };
 
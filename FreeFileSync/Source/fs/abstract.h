@@ -11,6 +11,8 @@
 #include <zen/file_error.h>
 #include <zen/zstring.h>
 #include <zen/serialize.h> //InputStream/OutputStream support buffered stream concept
+#include <zen/file_access.h> //FileCopyOptions
+#include <zen/concurrency_limit.h>
 #include <wx+/image_holder.h> //NOT a wxWidgets dependency!
 
 
@@ -194,6 +196,19 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
         const SymlinkInfo* symlinkInfo; //only filled if folder is a followed symlink
     };
 
+    //folder content persisted between traversals: AFS-specific, only the AFS that created it can validate it
+    struct FolderListing
+    {
+        struct Item
+        {
+            Zstring itemName;
+            unsigned char itemType = 0; //e.g. native: dirent::d_type
+            uint64_t itemId = 0;        //e.g. native: inode
+        };
+        std::string changeStamp; //e.g. native: device, inode, mtime and ctime of the folder; empty: never reuse
+        std::vector<Item> items;
+    };
+
     struct TraverserCallback
     {
         virtual ~TraverserCallback() {}
@@ -217,12 +232,19 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
 
         virtual HandleError reportDirError (const std::wstring& msg, size_t retryNumber) = 0; //failed directory traversal -> consider directory data at current level as incomplete!
         virtual HandleError reportItemError(const std::wstring& msg, size_t retryNumber, const Zstring& itemName) = 0; //failed to get data for single file/dir/symlink only!
+
+        //optional: incremental traversal => AFS may skip reading a folder that is unchanged since the previous traversal (item details are still retrieved!)
+        virtual bool                 wantFolderListing() { return false; }   //=> call onFolderListing() with the current listing
+        virtual const FolderListing* getFolderListing () { return nullptr; } //listing of previous traversal
+        virtual void                 onFolderListing  (const FolderListing& listing) {}
     };
 
     using TraverserWorkload = std::vector<std::pair<std::vector<Zstring> /*relPath*/, std::shared_ptr<TraverserCallback> /*throw X*/>>;
 
     //- client needs to handle duplicate file reports! (FilePlusTraverser fallback, retrying to read directory contents, ...)
-    static void traverseFolderRecursive(const AbstractPath& basePath, const TraverserWorkload& workload, size_t parallelOps);
+    //- parallelOpsLimit: optional, tune parallel operations at runtime; parallelOps is then the upper limit
+    //- a callback is released as soon as its folder and all pending item reads are done => callback life time tells when a sub tree is complete
+    static void traverseFolderRecursive(const AbstractPath& basePath, TraverserWorkload&& workload, size_t parallelOps, zen::AdaptiveConcurrencyLimit* parallelOpsLimit = nullptr);
 
     static void traverseFolderFlat(const AbstractPath& ap, //throw FileError
                                    const std::function<void (const FileInfo&    fi)>& onFile,     //
@@ -247,6 +269,7 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
         FileId sourceFileId;
         FileId targetFileId;
         std::optional<zen::FileError> errorModTime; //failure to set modification time
+        std::optional<uint64_t> contentDigest; //XXH64 of the data written, if requested via FileCopyOptions::computeDigest
     };
 
     //symlink handling: follow
@@ -256,6 +279,7 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
                                                 const AbstractPath& apTarget,
                                                 bool copyFilePermissions,
                                                 bool transactionalCopy,
+                                                const zen::FileCopyOptions& copyOptions,
                                                 //if target is existing user *must* implement deletion to avoid undefined behavior
                                                 //if transactionalCopy == true, full read access on source had been proven at this point, so it's safe to delete it.
                                                 const std::function<void()>& onDeleteTargetFile,
@@ -318,7 +342,8 @@ protected: //grant derived classes access to AbstractPath:
 
     //target existing: undefined behavior! (fail/overwrite/auto-rename)
     FileCopyResult copyFileAsStream(const AfsPath& afsPathSource, const StreamAttributes& attrSource, //throw FileError, ErrorFileLocked
-                                    const AbstractPath& apTarget, const zen::IOCallback& notifyUnbufferedIO) const; //may be nullptr; throw X!
+                                    const AbstractPath& apTarget, const zen::FileCopyOptions& copyOptions,
+                                    const zen::IOCallback& notifyUnbufferedIO) const; //may be nullptr; throw X!
 
     using TraverserWorkloadImpl = std::vector<std::pair<AfsPath, std::shared_ptr<TraverserCallback> /*throw X*/>>;
 
@@ -358,7 +383,7 @@ private:
                                                               const uint64_t* streamSize,                      //optional
                                                               const zen::IOCallback& notifyUnbufferedIO) const = 0; //
     //----------------------------------------------------------------------------------------------------------------
-    virtual void traverseFolderRecursive(const TraverserWorkloadImpl& workload /*throw X*/, size_t parallelOps) const = 0;
+    virtual void traverseFolderRecursive(TraverserWorkloadImpl&& workload /*throw X*/, size_t parallelOps, zen::AdaptiveConcurrencyLimit* parallelOpsLimit /*optional*/) const = 0;
     //----------------------------------------------------------------------------------------------------------------
     virtual bool supportsPermissions(const AfsPath& afsPath) const = 0; //throw FileError
 
@@ -368,7 +393,7 @@ private:
     //symlink handling: follow link!
     //target existing: undefined behavior! (fail/overwrite/auto-rename)
     virtual FileCopyResult copyFileForSameAfsType(const AfsPath& afsPathSource, const StreamAttributes& attrSource, //throw FileError, ErrorFileLocked
-                                                  const AbstractPath& apTarget, bool copyFilePermissions,
+                                                  const AbstractPath& apTarget, bool copyFilePermissions, const zen::FileCopyOptions& copyOptions,
                                                   //accummulated delta != file size! consider ADS, sparse, compressed files
                                                   const zen::IOCallback& notifyUnbufferedIO) const = 0; //may be nullptr; throw X!
 
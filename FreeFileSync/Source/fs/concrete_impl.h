@@ -7,6 +7,7 @@
 #ifndef IMPL_HELPER_H_873450978453042524534234
 #define IMPL_HELPER_H_873450978453042524534234
 
+#include <deque>
 #include "abstract.h"
 #include <zen/thread.h>
 
@@ -58,27 +59,61 @@ enum class SchedulerStatus
     FINISHED,
 };
 
+/* work-stealing scheduler:
+    - one task deque per worker: owner takes from the back, idle workers steal from the front of others
+    - results are handed to the controlling thread in batches => less lock contention + fewer wake-ups
+      flushed when full, when the worker goes idle, or when the oldest result exceeds RESULT_DELAY_MAX (checked after each task and before the next)
+    - controlling thread is the only one to call run() and getResults() => callbacks remain single-threaded
+    - optional: tasks run only within the (adaptive) concurrency limit */
 template <class Context, class... Functions> //avoid std::function memory alloc + virtual calls
 class TaskScheduler
 {
 public:
-    TaskScheduler(size_t threadCount, const std::string& groupName) :
-        threadGroup_(zen::ThreadGroup<std::function<void()>>(threadCount, groupName)) {}
+    TaskScheduler(size_t threadCount, zen::AdaptiveConcurrencyLimit* concurrencyLimit /*optional*/, const std::string& groupName) :
+        threadCountMax_(concurrencyLimit ? concurrencyLimit->getLimitMax() : threadCount), concurrencyLimit_(concurrencyLimit), groupName_(groupName)
+    {
+        if (threadCountMax_ == 0)
+            throw std::logic_error("Contract violation! " + std::string(__FILE__) + ":" + zen::numberTo<std::string>(__LINE__));
 
-    ~TaskScheduler() { threadGroup_ = {}; } //TaskScheduler must out-live threadGroup! (captured "this")
+        for (size_t i = 0; i < threadCountMax_; ++i)
+            workers_.push_back(std::make_unique<Worker>());
+    }
+
+    ~TaskScheduler() //TaskScheduler must out-live threads! (captured "this")
+    {
+        for (zen::InterruptibleThread& t : threads_) t.interrupt(); //interrupt all first, then join
+        for (zen::InterruptibleThread& t : threads_) t.join();
+    }
 
     //context of controlling thread, non-blocking:
     template <class Function>
     void run(Task<Context, Function>&& wi)
     {
-        threadGroup_->run([this, wi = std::move(wi)]
+        ++resultsPending_;
+
+        if (threads_.size() < std::min(resultsPending_, threadCountMax_))
+            addWorkerThread();
+
+        ++tasksQueued_; //increment *before* task becomes visible to workers
+        Worker& w = *workers_[nextWorker_++ % threads_.size()];
         {
-            try {         this->returnResult<Function>({ wi, nullptr, wi.getResult() }); } //throw FileError
-            catch (...) { this->returnResult<Function>({ wi, std::current_exception(), {} }); }
-        });
+            std::lock_guard<std::mutex> dummy(w.lockTasks);
+            w.tasks.push_back([wi = std::move(wi)](TaskScheduler& ts, size_t workerIdx) mutable
+            {
+                std::exception_ptr error;
+                decltype(wi.getResult()) value;
+                try { value = wi.getResult(); } //throw FileError
+                catch (...) { error = std::current_exception(); }
 
-        std::lock_guard<std::mutex> dummy(lockResult_);
-        ++resultsPending_;
+                ts.returnResult<Function>(workerIdx, { std::move(wi), error, std::move(value) });
+            });
+        }
+
+        if (workersIdle_ > 0) //seq_cst: see worker loop
+        {
+            { std::lock_guard<std::mutex> dummy(lockIdle_); } //worker is either waiting or has not yet checked tasksQueued_
+            conditionNewTask_.notify_one();
+        }
     }
 
     //context of controlling thread, blocking:
@@ -86,21 +121,16 @@ public:
     {
         std::apply([](auto&... r) { (..., r.clear()); }, results);
 
-        std::unique_lock<std::mutex> dummy(lockResult_);
-
-        auto resultsReady = [&]
-        {
-            bool ready = false;
-            std::apply([&ready](const auto&... r) { ready = (... || !r.empty()); }, results_);
-            return ready;
-        };
-
-        if (!resultsReady() && resultsPending_ == 0)
+        if (resultsPending_ == 0)
             return SchedulerStatus::FINISHED;
 
-        conditionNewResult_.wait(dummy, [&resultsReady] { return resultsReady(); });
+        std::unique_lock<std::mutex> dummy(lockResult_);
+
+        conditionNewResult_.wait(dummy, [&] { return resultCount_ > 0; });
 
         results.swap(results_); //reuse memory + avoid needless item-level mutex locking
+        resultsPending_ -= resultCount_;
+        resultCount_ = 0;
         return SchedulerStatus::HAVE_RESULT;
     }
 
@@ -108,23 +138,142 @@ private:
     TaskScheduler           (const TaskScheduler&) = delete;
     TaskScheduler& operator=(const TaskScheduler&) = delete;
 
-    //context of worker threads, non-blocking:
+    static constexpr size_t RESULT_BATCH_SIZE = 64;
+    static constexpr std::chrono::milliseconds RESULT_DELAY_MAX{ 20 }; //don't let the controlling thread wait on slow tasks (e.g. network folders)
+
+    struct Worker
+    {
+        std::mutex lockTasks;
+        std::deque<std::function<void(TaskScheduler& ts, size_t workerIdx)>> tasks;
+
+        std::tuple<std::vector<TaskResult<Context, Functions>>...> resultBatch; //worker thread only
+        size_t resultBatchCount = 0;                                           //
+        std::chrono::steady_clock::time_point resultBatchStart;                //
+    };
+
+    void addWorkerThread()
+    {
+        const size_t workerIdx = threads_.size();
+        std::string threadName = groupName_ + '[' + zen::numberTo<std::string>(workerIdx + 1) + '/' + zen::numberTo<std::string>(threadCountMax_) + ']';
+
+        threads_.emplace_back([this, workerIdx, threadName = std::move(threadName)]
+        {
+            zen::setCurrentThreadName(threadName.c_str());
+
+            for (;;)
+            {
+                {
+                    zen::ConcurrencySlot slot(concurrencyLimit_); //throw ThreadInterruption
+                    //=> *before* takeTask(): don't keep a task from being stolen while waiting for the limit
+
+                    if (std::function<void(TaskScheduler& ts, size_t workerIdx)> task = takeTask(workerIdx))
+                    {
+                        flushResultsIfDelayed(workerIdx); //next task might be slow (e.g. network folder)
+                        task(*this, workerIdx); //throw ThreadInterruption?
+                        continue;
+                    }
+                }
+
+                flushResults(workerIdx); //don't sit on results while idle!
+
+                std::unique_lock<std::mutex> dummy(lockIdle_);
+                ++workersIdle_;
+                ZEN_ON_SCOPE_EXIT(--workersIdle_);
+                zen::interruptibleWait(conditionNewTask_, dummy, [this] { return tasksQueued_ > 0; }); //throw ThreadInterruption
+            }
+        });
+    }
+
+    //context of worker threads:
+    std::function<void(TaskScheduler& ts, size_t workerIdx)> takeTask(size_t workerIdx)
+    {
+        const size_t workerCount = workers_.size();
+
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            Worker& w = *workers_[(workerIdx + i) % workerCount];
+
+            std::lock_guard<std::mutex> dummy(w.lockTasks);
+            if (!w.tasks.empty())
+            {
+                std::function<void(TaskScheduler& ts, size_t workerIdx)> task;
+                if (i == 0) //own deque: LIFO
+                {
+                    task = std::move(w.tasks.back());
+                    w.tasks.pop_back();
+                }
+                else //steal: FIFO
+                {
+                    task = std::move(w.tasks.front());
+                    w.tasks.pop_front();
+                }
+                --tasksQueued_;
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
     template <class Function>
-    void returnResult(TaskResult<Context, Function>&& r)
+    void returnResult(size_t workerIdx, TaskResult<Context, Function>&& r)
+    {
+        Worker& w = *workers_[workerIdx];
+        std::get<std::vector<TaskResult<Context, Function>>>(w.resultBatch).push_back(std::move(r));
+
+        if (w.resultBatchCount++ == 0)
+            w.resultBatchStart = std::chrono::steady_clock::now();
+
+        if (w.resultBatchCount >= RESULT_BATCH_SIZE)
+            flushResults(workerIdx);
+        else
+            flushResultsIfDelayed(workerIdx);
+    }
+
+    void flushResultsIfDelayed(size_t workerIdx)
     {
+        Worker& w = *workers_[workerIdx];
+        if (w.resultBatchCount > 0 && std::chrono::steady_clock::now() - w.resultBatchStart >= RESULT_DELAY_MAX)
+            flushResults(workerIdx);
+    }
+
+    void flushResults(size_t workerIdx)
+    {
+        Worker& w = *workers_[workerIdx];
+        if (w.resultBatchCount == 0)
+            return;
         {
             std::lock_guard<std::mutex> dummy(lockResult_);
 
-            std::get<std::vector<TaskResult<Context, Function>>>(results_).push_back(std::move(r));
-            --resultsPending_;
+            auto appendBatch = [](auto& batch, auto& results)
+            {
+                results.insert(results.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+                batch.clear();
+            };
+            (..., appendBatch(std::get<std::vector<TaskResult<Context, Functions>>>(w.resultBatch),
+                              std::get<std::vector<TaskResult<Context, Functions>>>(results_)));
+
+            resultCount_ += w.resultBatchCount;
+            w.resultBatchCount = 0;
         }
-        conditionNewResult_.notify_all();
+        conditionNewResult_.notify_one(); //only the controlling thread is waiting
     }
 
-    std::optional<zen::ThreadGroup<std::function<void()>>> threadGroup_;
+    const size_t threadCountMax_;
+    zen::AdaptiveConcurrencyLimit* const concurrencyLimit_;
+    const std::string groupName_;
+
+    std::vector<std::unique_ptr<Worker>> workers_; //fixed size: accessed by all threads
+    std::vector<zen::InterruptibleThread> threads_;           //controlling thread only
+    size_t nextWorker_ = 0;                                   //
+    size_t resultsPending_ = 0; //tasks run() but not yet returned by getResults() //
+
+    std::atomic<size_t> tasksQueued_{ 0 };
+    std::mutex lockIdle_;
+    std::atomic<size_t> workersIdle_{ 0 };
+    std::condition_variable conditionNewTask_;
 
     std::mutex lockResult_;
-    size_t resultsPending_ = 0;
+    size_t resultCount_ = 0;
     std::tuple<std::vector<TaskResult<Context, Functions>>...> results_;
     std::condition_variable conditionNewResult_;
 };
@@ -144,8 +293,8 @@ class GenericDirTraverser
 public:
     using Function1 = zen::GetFirstOfT<Functions...>;
 
-    GenericDirTraverser(std::vector<Task<TravContext, Function1>>&& initialTasks, size_t parallelOps, const std::string& threadGroupName) :
-        scheduler_(parallelOps, threadGroupName)
+    GenericDirTraverser(std::vector<Task<TravContext, Function1>>&& initialTasks, size_t parallelOps, zen::AdaptiveConcurrencyLimit* parallelOpsLimit /*optional*/, const std::string& threadGroupName) :
+        scheduler_(parallelOps, parallelOpsLimit, threadGroupName)
     {
         //set the initial work load
         for (auto& item : initialTasks)
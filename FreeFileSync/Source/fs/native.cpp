@@ -22,7 +22,9 @@
     #include <cstddef> //offsetof
     #include <sys/stat.h>
     #include <dirent.h>
-    #include <fcntl.h> //fallocate, fcntl
+    #include <fcntl.h> //fallocate, fcntl, openat
+    #include <sys/sysmacros.h> //makedev
+    #include <sys/resource.h> //getrlimit
 
 using namespace zen;
 using namespace fff;
@@ -50,24 +52,151 @@ AFS::FileId convertToAbstractFileId(const zen::FileId& fid)
 }
 
 
+//keep folder open while its items are examined: stat items relative to the folder instead of having the kernel re-walk the full path each time
+class DirHandle
+{
+public:
+    DirHandle(int fdDir, bool inodeOrder) : fd_(fdDir), inodeOrder_(inodeOrder) {}
+    ~DirHandle() { if (fd_ != -1) { ::close(fd_); --handlesInUse_; } }
+
+    int getFd() const { return fd_; } //-1 if not available => use full path
+    bool inodeOrder() const { return inodeOrder_; } //determined once per base folder: see isRotationalDevice()
+
+    //limit file descriptors held by pending items: leave enough for opening folders and files
+    static std::shared_ptr<const DirHandle> acquire(int fdDir, bool inodeOrder) //fdDir is NOT owned
+    {
+        static const int maxHandlesInUse = []
+        {
+            struct ::rlimit fdLimit = {};
+            if (::getrlimit(RLIMIT_NOFILE, &fdLimit) == 0 && fdLimit.rlim_cur != RLIM_INFINITY)
+                return static_cast<int>(std::min<rlim_t>(fdLimit.rlim_cur / 4, MAX_HANDLES_IN_USE));
+            return MAX_HANDLES_IN_USE;
+        }();
+
+        if (++handlesInUse_ <= maxHandlesInUse)
+        {
+            const int fdDup = ::fcntl(fdDir, F_DUPFD_CLOEXEC, 0);
+            if (fdDup != -1)
+                return std::make_shared<const DirHandle>(fdDup, inodeOrder);
+        }
+        --handlesInUse_;
+        return std::make_shared<const DirHandle>(-1, inodeOrder);
+    }
+
+private:
+    DirHandle           (const DirHandle&) = delete;
+    DirHandle& operator=(const DirHandle&) = delete;
+
+    static constexpr int MAX_HANDLES_IN_USE = 256;
+    static inline std::atomic<int> handlesInUse_{ 0 };
+
+    const int fd_;
+    const bool inodeOrder_;
+};
+
+
+//spinning disks: stat folder items in inode order => less seeking between inode table blocks
+bool isRotationalDevice(dev_t devId)
+{
+    static std::mutex lockCache;
+    static std::map<dev_t, bool> rotationalCache;
+    {
+        std::lock_guard<std::mutex> dummy(lockCache);
+        if (auto it = rotationalCache.find(devId); it != rotationalCache.end())
+            return it->second;
+    }
+
+    const Zstring devPath = Zstr("/sys/dev/block/") + numberTo<Zstring>(major(devId)) + Zstr(':') + numberTo<Zstring>(minor(devId));
+    bool rotational = false;
+
+    for (const Zstring& queuePath : { devPath + Zstr("/queue/rotational"), devPath + Zstr("/../queue/rotational") /*partition: see parent disk*/ })
+        try
+        {
+            rotational = trimCpy(loadBinContainer<std::string>(queuePath, nullptr /*notifyUnbufferedIO*/)) == "1"; //throw FileError
+            break;
+        }
+        catch (FileError&) {} //not a block device: e.g. network share, FUSE, btrfs (anonymous device id)
+
+    std::lock_guard<std::mutex> dummy(lockCache);
+    rotationalCache.emplace(devId, rotational);
+    return rotational;
+}
+
+
+//folder items are unchanged as long as these are: item creation, deletion and rename update both mtime and ctime
+std::string getChangeStamp(const struct ::stat& dirInfo)
+{
+    //racy: folder modified within the file system's time stamp granularity => a later modification might leave the time stamps unchanged
+    struct ::timespec now = {};
+    if (::clock_gettime(CLOCK_REALTIME, &now) != 0 ||
+        now.tv_sec - dirInfo.st_mtim.tv_sec < 2 ||
+        now.tv_sec - dirInfo.st_ctim.tv_sec < 2)
+        return std::string(); //=> not reusable
+
+    const uint64_t stamp[] =
+    {
+        static_cast<uint64_t>(dirInfo.st_dev),
+        static_cast<uint64_t>(dirInfo.st_ino),
+        static_cast<uint64_t>(dirInfo.st_mtim.tv_sec), static_cast<uint64_t>(dirInfo.st_mtim.tv_nsec),
+        static_cast<uint64_t>(dirInfo.st_ctim.tv_sec), static_cast<uint64_t>(dirInfo.st_ctim.tv_nsec)
+    };
+    return std::string(reinterpret_cast<const char*>(stamp), sizeof(stamp));
+}
+
+
 struct FsItemRaw
 {
     Zstring itemName;
     Zstring itemPath;
+    std::shared_ptr<const DirHandle> parentDir; //never nullptr
+    unsigned char type; //dirent::d_type: DT_UNKNOWN if not supported by the file system => stat needed
+    ino_t inode;        //dirent::d_ino
+};
+struct DirContentRaw
+{
+    std::vector<FsItemRaw> items;
+    std::optional<AFS::FolderListing> listing; //only if requested
 };
-std::vector<FsItemRaw> getDirContentFlat(const Zstring& dirPath) //throw FileError
+DirContentRaw getDirContentFlat(const Zstring& dirPath, const DirHandle* parentDir /*optional*/, const Zstring& dirName, //throw FileError
+                                const AFS::FolderListing* prevListing /*optional*/, bool wantListing)
 {
     //no need to check for endless recursion:
     //1. Linux has a fixed limit on the number of symbolic links in a path
     //2. fails with "too many open files" or "path too long" before reaching stack overflow
 
-    DIR* folder = ::opendir(dirPath.c_str()); //directory must NOT end with path separator, except "/"
+    const int fdDir = parentDir && parentDir->getFd() != -1 ? //open(at) follows symlinks: fine for AFS::TraverserCallback::LINK_FOLLOW
+                      ::openat(parentDir->getFd(), dirName.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC) :
+                      ::open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fdDir == -1)
+        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot open directory %x."), L"%x", fmtPath(dirPath)), L"open");
+
+    DIR* folder = ::fdopendir(fdDir); //takes ownership of fdDir on success
     if (!folder)
-        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot open directory %x."), L"%x", fmtPath(dirPath)), L"opendir");
+    {
+        const ErrorCode ec = getLastError(); //copy before making other system calls!
+        ::close(fdDir);
+        throw FileError(replaceCpy(_("Cannot open directory %x."), L"%x", fmtPath(dirPath)), formatSystemError(L"fdopendir", ec));
+    }
     ZEN_ON_SCOPE_EXIT(::closedir(folder)); //never close nullptr handles! -> crash
 
-    std::vector<FsItemRaw> output;
-    for (;;)
+    struct ::stat dirInfo = {};
+    const bool haveDirInfo = (!parentDir || prevListing || wantListing) && ::fstat(fdDir, &dirInfo) == 0;
+    const bool inodeOrder  = parentDir ? parentDir->inodeOrder() : haveDirInfo && isRotationalDevice(dirInfo.st_dev); //subfolders: assume same device as base folder
+    const std::string changeStamp = haveDirInfo && (prevListing || wantListing) ? getChangeStamp(dirInfo) : std::string();
+
+    const std::shared_ptr<const DirHandle> dirHandle = DirHandle::acquire(fdDir, inodeOrder);
+
+    DirContentRaw output;
+
+    if (prevListing && !changeStamp.empty() && prevListing->changeStamp == changeStamp) //folder unchanged: skip readdir
+    {
+        for (const AFS::FolderListing::Item& item : prevListing->items)
+            output.items.push_back({ item.itemName, appendSeparator(dirPath) + item.itemName, dirHandle, item.itemType, static_cast<ino_t>(item.itemId) });
+
+        if (wantListing)
+            output.listing = *prevListing;
+    }
+    else for (;;)
     {
         /*
             Linux:
@@ -84,7 +213,7 @@ std::vector<FsItemRaw> getDirContentFlat(const Zstring& dirPath) //throw FileErr
         if (!dirEntry)
         {
             if (errno == 0) //errno left unchanged => no more items
-                return output;
+                break;
 
             THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(dirPath)), L"readdir");
             //don't retry but restart dir traversal on error! https://blogs.msdn.microsoft.com/oldnewthing/20140612-00/?p=753/
@@ -102,8 +231,20 @@ std::vector<FsItemRaw> getDirContentFlat(const Zstring& dirPath) //throw FileErr
 
         const Zstring& itemPath = appendSeparator(dirPath) + itemName;
 
-        output.push_back({ itemName, itemPath});
+        output.items.push_back({ itemName, itemPath, dirHandle, dirEntry->d_type, dirEntry->d_ino });
     }
+
+    if (inodeOrder) //=> order of GetItemDetails and subfolder traversal
+        std::sort(output.items.begin(), output.items.end(), [](const FsItemRaw& lhs, const FsItemRaw& rhs) { return lhs.inode < rhs.inode; });
+
+    if (wantListing && !output.listing)
+    {
+        AFS::FolderListing& listing = output.listing.emplace();
+        listing.changeStamp = changeStamp;
+        for (const FsItemRaw& item : output.items)
+            listing.items.push_back({ item.itemName, item.type, item.inode });
+    }
+    return output;
 }
 
 
@@ -114,47 +255,94 @@ struct ItemDetailsRaw
     uint64_t fileSize; //unit: bytes!
     FileId   fileId;
 };
-ItemDetailsRaw getItemDetails(const Zstring& itemPath) //throw FileError
+ItemDetailsRaw getItemDetailsRaw(const FsItemRaw& rawItem, bool followSymlink) //throw FileError
 {
+    auto errorMsg = [&] //error path only: don't format (and allocate) a message per item
+    {
+        return replaceCpy(followSymlink ? _("Cannot resolve symbolic link %x.") : _("Cannot read file attributes of %x."), L"%x", fmtPath(rawItem.itemPath));
+    };
+    const int  fdDir    = rawItem.parentDir->getFd() != -1 ? rawItem.parentDir->getFd() : AT_FDCWD;
+    const char* relPath = rawItem.parentDir->getFd() != -1 ? rawItem.itemName.c_str() : rawItem.itemPath.c_str();
+    const int  flags    = followSymlink ? 0 : AT_SYMLINK_NOFOLLOW; //on Linux there is no distinction between file and directory symlinks!
+
+    static std::atomic<bool> statxUnavailable{ false }; //kernel < 4.11
+    if (!statxUnavailable)
+    {
+        //request only what's needed: e.g. no atime/ctime/btime => network file systems may skip server round trips
+        const unsigned int STATX_NEEDED = STATX_TYPE | STATX_MTIME | STATX_SIZE | STATX_INO;
+
+        struct ::statx statxData = {};
+        if (::statx(fdDir, relPath, flags | AT_STATX_SYNC_AS_STAT, STATX_NEEDED, &statxData) == 0)
+        {
+            if ((statxData.stx_mask & STATX_NEEDED) == STATX_NEEDED) //else: fall back to fstatat()
+            {
+                const dev_t devId = makedev(statxData.stx_dev_major, statxData.stx_dev_minor);
+                const FileId fileId = devId != 0 && statxData.stx_ino != 0 ? FileId(devId, statxData.stx_ino) : FileId();
+                const time_t modTime = statxData.stx_mtime.tv_sec;
+
+                if (S_ISLNK(statxData.stx_mode))
+                    return { ItemType::SYMLINK, modTime, 0, fileId };
+                else if (S_ISDIR(statxData.stx_mode)) //a directory
+                    return { ItemType::FOLDER, modTime, 0, fileId };
+                else //a file or named pipe, ect. => dont't check using S_ISREG(): see comment in file_traverser.cpp
+                    return { ItemType::FILE, modTime, statxData.stx_size, fileId };
+            }
+        }
+        else
+        {
+            const ErrorCode ec = getLastError(); //copy before making other system calls!
+            if (ec == ENOSYS)
+                statxUnavailable = true;
+            else if (ec != EPERM && ec != EACCES) //EPERM: blocked (seccomp) or item-specific => fall back for this item only; fstatat() reports real errors
+                throw FileError(errorMsg(), formatSystemError(L"statx", ec));
+        }
+    }
+
     struct ::stat statData = {};
-    if (::lstat(itemPath.c_str(), &statData) != 0) //lstat() does not resolve symlinks
-        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(itemPath)), L"lstat");
+    if (::fstatat(fdDir, relPath, &statData, flags) != 0)
+        THROW_LAST_FILE_ERROR(errorMsg(), L"fstatat");
 
-    if (S_ISLNK(statData.st_mode)) //on Linux there is no distinction between file and directory symlinks!
+    if (S_ISLNK(statData.st_mode))
         return { ItemType::SYMLINK, statData.st_mtime, 0, extractFileId(statData) };
-
     else if (S_ISDIR(statData.st_mode)) //a directory
         return { ItemType::FOLDER, statData.st_mtime, 0, extractFileId(statData) };
-
     else //a file or named pipe, ect. => dont't check using S_ISREG(): see comment in file_traverser.cpp
         return { ItemType::FILE, statData.st_mtime, makeUnsigned(statData.st_size), extractFileId(statData) };
 }
 
-ItemDetailsRaw getSymlinkTargetDetails(const Zstring& linkPath) //throw FileError
+ItemDetailsRaw getItemDetails(const FsItemRaw& rawItem) //throw FileError
 {
-    struct ::stat statData = {};
-    if (::stat(linkPath.c_str(), &statData) != 0)
-        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot resolve symbolic link %x."), L"%x", fmtPath(linkPath)), L"stat");
+    return getItemDetailsRaw(rawItem, false /*followSymlink*/); //throw FileError
+}
 
-    if (S_ISDIR(statData.st_mode)) //a directory
-        return { ItemType::FOLDER, statData.st_mtime, 0, extractFileId(statData) };
-    else //a file or named pipe, ect.
-        return { ItemType::FILE, statData.st_mtime, makeUnsigned(statData.st_size), extractFileId(statData) };
+ItemDetailsRaw getSymlinkTargetDetails(const FsItemRaw& rawLink) //throw FileError
+{
+    const ItemDetailsRaw details = getItemDetailsRaw(rawLink, true /*followSymlink*/); //throw FileError
+    assert(details.type != ItemType::SYMLINK);
+    return details;
 }
 
 
 struct GetDirDetails
 {
-    GetDirDetails(const Zstring& dirPath) : dirPath_(dirPath) {}
+    //context of controlling thread: cb is not thread-safe
+    GetDirDetails(const Zstring& dirPath, AFS::TraverserCallback& cb) :
+        dirPath_(dirPath), prevListing_(cb.getFolderListing()), wantListing_(cb.wantFolderListing()) {}
+    GetDirDetails(const FsItemRaw& rawItem, AFS::TraverserCallback& cb) :
+        dirPath_(rawItem.itemPath), dirName_(rawItem.itemName), parentDir_(rawItem.parentDir), prevListing_(cb.getFolderListing()), wantListing_(cb.wantFolderListing()) {}
 
-    using Result = std::vector<FsItemRaw>;
+    using Result = DirContentRaw;
     Result operator()() const
     {
-        return getDirContentFlat(dirPath_); //throw FileError
+        return getDirContentFlat(dirPath_, parentDir_.get(), dirName_, prevListing_, wantListing_); //throw FileError
     }
 
 private:
     Zstring dirPath_;
+    Zstring dirName_;                            //
+    std::shared_ptr<const DirHandle> parentDir_; //optional: relative access
+    const AFS::FolderListing* prevListing_;      //optional: immutable during traversal
+    bool wantListing_;
 };
 
 
@@ -169,7 +357,7 @@ struct GetItemDetails //details not already retrieved by raw folder traversal
     };
     Result operator()() const
     {
-        return { rawItem_, getItemDetails(rawItem_.itemPath) }; //throw FileError
+        return { rawItem_, getItemDetails(rawItem_) }; //throw FileError
     }
 
 private:
@@ -189,7 +377,7 @@ struct GetLinkTargetDetails
     };
     Result operator()() const
     {
-        return { rawItem_, linkDetails_, getSymlinkTargetDetails(rawItem_.itemPath) }; //throw FileError
+        return { rawItem_, linkDetails_, getSymlinkTargetDetails(rawItem_) }; //throw FileError
     }
 
 private:
@@ -198,15 +386,15 @@ private:
 };
 
 
-void traverseFolderRecursiveNative(const std::vector<std::pair<Zstring, std::shared_ptr<AFS::TraverserCallback>>>& initialTasks, size_t parallelOps) //throw X
+void traverseFolderRecursiveNative(std::vector<std::pair<Zstring, std::shared_ptr<AFS::TraverserCallback>>>&& initialTasks, size_t parallelOps, AdaptiveConcurrencyLimit* parallelOpsLimit) //throw X
 {
     std::vector<Task<TravContext, GetDirDetails>> genItems;
 
-    for (const auto& item : initialTasks)
-        genItems.push_back({ GetDirDetails(item.first),
-                             TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, item.second /*TraverserCallback*/ }});
+    for (auto& item : initialTasks)
+        genItems.push_back({ GetDirDetails(item.first, *item.second),
+                             TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(item.second) /*TraverserCallback*/ }});
 
-    GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>(std::move(genItems), parallelOps, "Native Traverser"); //throw X
+    GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>(std::move(genItems), parallelOps, parallelOpsLimit, "Native Traverser"); //throw X
 }
 }
 
@@ -216,8 +404,17 @@ template <>
 template <>
 void GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>::evalResultValue<GetDirDetails>(const GetDirDetails::Result& r, std::shared_ptr<AFS::TraverserCallback>& cb) //throw X
 {
-    for (const FsItemRaw& rawItem : r)
-        scheduler_.run<GetItemDetails>({ GetItemDetails(rawItem), TravContext{ rawItem.itemName, 0 /*errorRetryCount*/, cb }});
+    if (r.listing)
+        cb->onFolderListing(*r.listing); //throw X
+
+    for (const FsItemRaw& rawItem : r.items)
+        if (rawItem.type == DT_DIR) //folder details are not needed: skip stat
+        {
+            if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb->onFolder({ rawItem.itemName, nullptr /*symlinkInfo*/ })) //throw X
+                scheduler_.run<GetDirDetails>({ GetDirDetails(rawItem, *cbSub), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(cbSub) }});
+        }
+        else //files and symlinks: need size, modification time and file id => DT_UNKNOWN: type determined by stat
+            scheduler_.run<GetItemDetails>({ GetItemDetails(rawItem), TravContext{ rawItem.itemName, 0 /*errorRetryCount*/, cb }});
 }
 
 
@@ -233,7 +430,7 @@ void GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>::e
 
         case ItemType::FOLDER:
             if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb->onFolder({ r.raw.itemName, nullptr /*symlinkInfo*/ })) //throw X
-                scheduler_.run<GetDirDetails>({ GetDirDetails(r.raw.itemPath), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(cbSub) }});
+                scheduler_.run<GetDirDetails>({ GetDirDetails(r.raw, *cbSub), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(cbSub) }});
             break;
 
         case ItemType::SYMLINK:
@@ -262,7 +459,7 @@ void GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>::e
     if (r.target.type == ItemType::FOLDER)
     {
         if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb->onFolder({ r.raw.itemName, &linkInfo })) //throw X
-            scheduler_.run<GetDirDetails>({ GetDirDetails(r.raw.itemPath), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(cbSub) }});
+            scheduler_.run<GetDirDetails>({ GetDirDetails(r.raw, *cbSub), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(cbSub) }});
     }
     else //a file or named pipe, ect.
         cb->onFile({ r.raw.itemName, r.target.fileSize, r.target.modTime, convertToAbstractFileId(r.target.fileId), &linkInfo }); //throw X
@@ -476,35 +673,37 @@ private:
     }
 
     //----------------------------------------------------------------------------------------------------------------
-    void traverseFolderRecursive(const TraverserWorkloadImpl& workload /*throw X*/, size_t parallelOps) const override
+    void traverseFolderRecursive(TraverserWorkloadImpl&& workload /*throw X*/, size_t parallelOps, AdaptiveConcurrencyLimit* parallelOpsLimit) const override
     {
         //initComForThread() -> done on traverser worker threads
 
         std::vector<std::pair<Zstring, std::shared_ptr<TraverserCallback>>> initialWorkItems;
-        for (const auto& item : workload)
-            initialWorkItems.emplace_back(getNativePath(item.first), item.second);
+        for (auto& item : workload)
+            initialWorkItems.emplace_back(getNativePath(item.first), std::move(item.second));
 
-        traverseFolderRecursiveNative(initialWorkItems, parallelOps); //throw X
+        traverseFolderRecursiveNative(std::move(initialWorkItems), parallelOps, parallelOpsLimit); //throw X
     }
     //----------------------------------------------------------------------------------------------------------------
 
     //symlink handling: follow link!
     //target existing: undefined behavior! (fail/overwrite/auto-rename) => Native will fail and give a clear error message
     FileCopyResult copyFileForSameAfsType(const AfsPath& afsPathSource, const StreamAttributes& attrSource, //throw FileError, ErrorFileLocked
-                                          const AbstractPath& apTarget, bool copyFilePermissions, const IOCallback& notifyUnbufferedIO) const override //may be nullptr; throw X!
+                                          const AbstractPath& apTarget, bool copyFilePermissions, const FileCopyOptions& copyOptions,
+                                          const IOCallback& notifyUnbufferedIO) const override //may be nullptr; throw X!
     {
         const Zstring nativePathTarget = static_cast<const NativeFileSystem&>(getAfs(apTarget)).getNativePath(getAfsPath(apTarget));
 
         initComForThread(); //throw FileError
 
         const zen::FileCopyResult nativeResult = copyNewFile(getNativePath(afsPathSource), nativePathTarget, //throw FileError, ErrorTargetExisting, ErrorFileLocked
-                                                             copyFilePermissions, notifyUnbufferedIO); //may be nullptr; throw X!
+                                                             copyFilePermissions, copyOptions, notifyUnbufferedIO); //may be nullptr; throw X!
         FileCopyResult result;
         result.fileSize     = nativeResult.fileSize;
         result.modTime      = nativeResult.modTime;
         result.sourceFileId = convertToAbstractFileId(nativeResult.sourceFileId);
         result.targetFileId = convertToAbstractFileId(nativeResult.targetFileId);
         result.errorModTime = nativeResult.errorModTime;
+        result.contentDigest = nativeResult.contentDigest;
         return result;
     }
 
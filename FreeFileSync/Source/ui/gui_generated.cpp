@@ -1384,6 +1384,11 @@ ConfigDlgGenerated::ConfigDlgGenerated( wxWindow* parent, wxWindowID id, const w
 
     bSizer2381->Add( m_toggleBtnByContent, 0, wxEXPAND|wxBOTTOM, 5 );
 
+    m_toggleBtnByContentCached = new wxToggleButton( m_panelComparisonSettings, wxID_ANY, _("File content (cached)"), wxDefaultPosition, wxSize( -1, -1 ), 0 );
+    m_toggleBtnByContentCached->SetFont( wxFont( wxNORMAL_FONT->GetPointSize(), wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD, false, wxEmptyString ) );
+
+    bSizer2381->Add( m_toggleBtnByContentCached, 0, wxEXPAND|wxBOTTOM, 5 );
+
     m_toggleBtnBySize = new wxToggleButton( m_panelComparisonSettings, wxID_ANY, _("File size"), wxDefaultPosition, wxSize( -1, -1 ), 0 );
     m_toggleBtnBySize->SetFont( wxFont( wxNORMAL_FONT->GetPointSize(), wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD, false, wxEmptyString ) );
 
@@ -2395,6 +2400,8 @@ ConfigDlgGenerated::ConfigDlgGenerated( wxWindow* parent, wxWindowID id, const w
     m_toggleBtnByTimeSize->Connect( wxEVT_COMMAND_TOGGLEBUTTON_CLICKED, wxCommandEventHandler( ConfigDlgGenerated::OnCompByTimeSize ), NULL, this );
     m_toggleBtnByContent->Connect( wxEVT_LEFT_DCLICK, wxMouseEventHandler( ConfigDlgGenerated::OnCompByContentDouble ), NULL, this );
     m_toggleBtnByContent->Connect( wxEVT_COMMAND_TOGGLEBUTTON_CLICKED, wxCommandEventHandler( ConfigDlgGenerated::OnCompByContent ), NULL, this );
+    m_toggleBtnByContentCached->Connect( wxEVT_LEFT_DCLICK, wxMouseEventHandler( ConfigDlgGenerated::OnCompByContentCachedDouble ), NULL, this );
+    m_toggleBtnByContentCached->Connect( wxEVT_COMMAND_TOGGLEBUTTON_CLICKED, wxCommandEventHandler( ConfigDlgGenerated::OnCompByContentCached ), NULL, this );
     m_toggleBtnBySize->Connect( wxEVT_LEFT_DCLICK, wxMouseEventHandler( ConfigDlgGenerated::OnCompBySizeDouble ), NULL, this );
     m_toggleBtnBySize->Connect( wxEVT_COMMAND_TOGGLEBUTTON_CLICKED, wxCommandEventHandler( ConfigDlgGenerated::OnCompBySize ), NULL, this );
     m_checkBoxSymlinksInclude->Connect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigDlgGenerated::OnChangeCompOption ), NULL, this );
@@ -4101,6 +4108,17 @@ OptionsDlgGenerated::OptionsDlgGenerated( wxWindow* parent, wxWindowID id, const
 
     bSizer160->Add( bSizer176, 0, wxEXPAND, 5 );
 
+    m_checkBoxCacheNeutral = new wxCheckBox( m_panel39, wxID_ANY, _("Cache-neutral file copy"), wxDefaultPosition, wxDefaultSize, 0 );
+    m_checkBoxCacheNeutral->SetToolTip( _("Release copied data from the system file cache.\nAvoids slowing down other applications during large synchronizations.") );
+
+    bSizer160->Add( m_checkBoxCacheNeutral, 0, wxALL|wxEXPAND, 5 );
+
+    m_checkBoxDetectMovedByContent = new wxCheckBox( m_panel39, wxID_ANY, _("Detect moved files by content"), wxDefaultPosition, wxDefaultSize, 0 );
+    m_checkBoxDetectMovedByContent->SetToolTip( _("Find moved and renamed files without a sync database by comparing file content.
+Reads files that exist on one side only.") );
+
+    bSizer160->Add( m_checkBoxDetectMovedByContent, 0, wxALL|wxEXPAND, 5 );
+
     bSizerLockedFiles = new wxBoxSizer( wxHORIZONTAL );
 
     m_checkBoxCopyLocked = new wxCheckBox( m_panel39, wxID_ANY, _("Copy locked files"), wxDefaultPosition, wxDefaultSize, 0 );
@@ -326,6 +326,7 @@ protected:
     wxStaticText* m_staticText91;
     wxToggleButton* m_toggleBtnByTimeSize;
     wxToggleButton* m_toggleBtnByContent;
+    wxToggleButton* m_toggleBtnByContentCached;
     wxToggleButton* m_toggleBtnBySize;
     wxStaticBitmap* m_bitmapCompVariant;
     wxStaticText* m_staticTextCompVarDescription;
@@ -480,6 +481,8 @@ protected:
     virtual void OnCompByTimeSize( wxCommandEvent& event ) { event.Skip(); }
     virtual void OnCompByContentDouble( wxMouseEvent& event ) { event.Skip(); }
     virtual void OnCompByContent( wxCommandEvent& event ) { event.Skip(); }
+    virtual void OnCompByContentCachedDouble( wxMouseEvent& event ) { event.Skip(); }
+    virtual void OnCompByContentCached( wxCommandEvent& event ) { event.Skip(); }
     virtual void OnCompBySizeDouble( wxMouseEvent& event ) { event.Skip(); }
     virtual void OnCompBySize( wxCommandEvent& event ) { event.Skip(); }
     virtual void OnChangeCompOption( wxCommandEvent& event ) { event.Skip(); }
@@ -964,6 +967,8 @@ protected:
     wxStaticText* m_staticText911;
     wxStaticText* m_staticText91;
     wxStaticText* m_staticText9111;
+    wxCheckBox* m_checkBoxCacheNeutral;
+    wxCheckBox* m_checkBoxDetectMovedByContent;
     wxBoxSizer* bSizerLockedFiles;
     wxCheckBox* m_checkBoxCopyLocked;
     wxStaticText* m_staticText921;
@@ -359,6 +359,8 @@ void MainDialog::create(const Zstring& globalConfigFilePath,
         //continue!
     }
 
+    enableAsyncFileIo(globSett.asyncFileIo);
+
     MainDialog* frame = new MainDialog(globalConfigFilePath, guiCfg, referenceFiles, globSett, startComparison);
     frame->Show();
 }
@@ -2634,6 +2636,7 @@ void MainDialog::OnCompSettingsContext(wxEvent& event)
     addVariantItem(CompareVariant::TIME_SIZE, L"cmp_file_time_sicon");
     addVariantItem(CompareVariant::CONTENT,   L"cmp_file_content_sicon");
     addVariantItem(CompareVariant::SIZE,      L"cmp_file_size_sicon");
+    addVariantItem(CompareVariant::CONTENT_CACHED, L"cmp_file_content_sicon");
 
     //menu.addRadio(getVariantName(CompareVariant::TIME_SIZE), [&] { setVariant(CompareVariant::TIME_SIZE); }, activeCmpVar == CompareVariant::TIME_SIZE);
     //menu.addRadio(getVariantName(CompareVariant::CONTENT  ), [&] { setVariant(CompareVariant::CONTENT);   }, activeCmpVar == CompareVariant::CONTENT);
@@ -3695,6 +3698,9 @@ void MainDialog::OnCompare(wxCommandEvent& event)
                              dirLocks,
                              extractCompareCfg(guiCfg.mainCfg),
                              deviceParallelOps,
+                             globalCfg_.adaptiveParallelOps ? globalCfg_.adaptiveParallelOpsMax : 0,
+                             globalCfg_.incrementalScan ? std::max<size_t>(globalCfg_.incrementalScanFullRescanInterval, 1) : 0,
+                             globalCfg_.detectMovedFilesByContent ? std::max<uint64_t>(globalCfg_.detectMovedFilesByContentMinSizeMB * 1024 * 1024ULL, 1) : 0,
                              statusHandler); //throw AbortProcess
     }
     catch (AbortProcess&) {}
@@ -3836,6 +3842,7 @@ void MainDialog::applyCompareConfig(bool setDefaultViewType)
                 break;
 
             case CompareVariant::CONTENT:
+            case CompareVariant::CONTENT_CACHED:
                 setViewTypeSyncAction(false);
                 break;
         }
@@ -3930,11 +3937,16 @@ void MainDialog::OnStartSync(wxCommandEvent& event)
                         globalCfg_.copyLockedFiles,
                         globalCfg_.copyFilePermissions,
                         globalCfg_.failSafeFileCopy,
+                        globalCfg_.cacheNeutralFileCopy,
+                        static_cast<uint64_t>(globalCfg_.directIoMinSizeMB) * 1024 * 1024,
+                        static_cast<uint64_t>(globalCfg_.chunkedCopyMinSizeMB) * 1024 * 1024,
                         globalCfg_.runWithBackgroundPriority,
                         globalCfg_.folderAccessTimeout,
                         extractSyncCfg(guiCfg.mainCfg),
                         folderCmp_,
                         deviceParallelOps,
+                        globalCfg_.adaptiveParallelOps ? globalCfg_.adaptiveParallelOpsMax : 0,
+                        guiCfg.mainCfg.deviceCopyBuffers,
                         globalCfg_.warnDlgs,
                         statusHandler); //throw AbortProcess
         }
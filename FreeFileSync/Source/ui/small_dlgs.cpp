@@ -597,6 +597,8 @@ OptionsDlg::OptionsDlg(wxWindow* parent, XmlGlobalSettings& globalSettings) :
     m_staticTextResetDialogs->Wrap(std::max(fastFromDIP(250), m_buttonResetDialogs->GetMinSize().x));
 
     m_checkBoxFailSafe       ->SetValue(globalSettings.failSafeFileCopy);
+    m_checkBoxCacheNeutral   ->SetValue(globalSettings.cacheNeutralFileCopy);
+    m_checkBoxDetectMovedByContent->SetValue(globalSettings.detectMovedFilesByContent);
     m_checkBoxCopyLocked     ->SetValue(globalSettings.copyLockedFiles);
     m_checkBoxCopyPermissions->SetValue(globalSettings.copyFilePermissions);
 
@@ -682,6 +684,8 @@ void OptionsDlg::OnResetDialogs(wxCommandEvent& event)
 void OptionsDlg::OnDefault(wxCommandEvent& event)
 {
     m_checkBoxFailSafe       ->SetValue(defaultCfg_.failSafeFileCopy);
+    m_checkBoxCacheNeutral   ->SetValue(defaultCfg_.cacheNeutralFileCopy);
+    m_checkBoxDetectMovedByContent->SetValue(defaultCfg_.detectMovedFilesByContent);
     m_checkBoxCopyLocked     ->SetValue(defaultCfg_.copyLockedFiles);
     m_checkBoxCopyPermissions->SetValue(defaultCfg_.copyFilePermissions);
 
@@ -698,6 +702,8 @@ void OptionsDlg::OnOkay(wxCommandEvent& event)
 {
     //write settings only when okay-button is pressed (except hidden dialog reset)!
     globalCfgOut_.failSafeFileCopy    = m_checkBoxFailSafe->GetValue();
+    globalCfgOut_.cacheNeutralFileCopy = m_checkBoxCacheNeutral->GetValue();
+    globalCfgOut_.detectMovedFilesByContent = m_checkBoxDetectMovedByContent->GetValue();
     globalCfgOut_.copyLockedFiles     = m_checkBoxCopyLocked->GetValue();
     globalCfgOut_.copyFilePermissions = m_checkBoxCopyPermissions->GetValue();
 
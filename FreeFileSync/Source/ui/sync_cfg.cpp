@@ -77,9 +77,11 @@ private:
     void OnCompByTimeSize         (wxCommandEvent& event) override { localCmpVar_ = CompareVariant::TIME_SIZE; updateCompGui(); updateSyncGui(); } //
     void OnCompByContent          (wxCommandEvent& event) override { localCmpVar_ = CompareVariant::CONTENT;   updateCompGui(); updateSyncGui(); } //affects sync settings, too!
     void OnCompBySize             (wxCommandEvent& event) override { localCmpVar_ = CompareVariant::SIZE;      updateCompGui(); updateSyncGui(); } //
+    void OnCompByContentCached    (wxCommandEvent& event) override { localCmpVar_ = CompareVariant::CONTENT_CACHED; updateCompGui(); updateSyncGui(); } //
     void OnCompByTimeSizeDouble   (wxMouseEvent&   event) override;
     void OnCompBySizeDouble       (wxMouseEvent&   event) override;
     void OnCompByContentDouble    (wxMouseEvent&   event) override;
+    void OnCompByContentCachedDouble(wxMouseEvent& event) override;
     void OnChangeCompOption       (wxCommandEvent& event) override { updateCompGui(); }
     void onlTimeShiftKeyDown      (wxKeyEvent& event) override;
 
@@ -199,6 +201,8 @@ std::wstring getCompVariantDescription(CompareVariant var)
             return _("Identify equal files by comparing the file content.");
         case CompareVariant::SIZE:
             return _("Identify equal files by comparing their file size.");
+        case CompareVariant::CONTENT_CACHED:
+            return _("Identify equal files by comparing the file content. Content hashes are stored next to the database and reused for unchanged files.");
     }
     assert(false);
     return _("Error");
@@ -299,10 +303,12 @@ commandHistItemsMax_(commandHistItemsMax)
     setRelativeFontSize(*m_toggleBtnByTimeSize, 1.25);
     setRelativeFontSize(*m_toggleBtnBySize,     1.25);
     setRelativeFontSize(*m_toggleBtnByContent,  1.25);
+    setRelativeFontSize(*m_toggleBtnByContentCached, 1.25);
 
     m_toggleBtnByTimeSize->SetToolTip(getCompVariantDescription(CompareVariant::TIME_SIZE));
     m_toggleBtnByContent ->SetToolTip(getCompVariantDescription(CompareVariant::CONTENT));
     m_toggleBtnBySize    ->SetToolTip(getCompVariantDescription(CompareVariant::SIZE));
+    m_toggleBtnByContentCached->SetToolTip(getCompVariantDescription(CompareVariant::CONTENT_CACHED));
 
     m_staticTextCompVarDescription->SetMinSize(wxSize(fastFromDIP(CFG_DESCRIPTION_WIDTH_DIP), -1));
 
@@ -553,6 +559,14 @@ void ConfigDialog::OnCompByContentDouble(wxMouseEvent& event)
 }
 
 
+void ConfigDialog::OnCompByContentCachedDouble(wxMouseEvent& event)
+{
+    wxCommandEvent dummy;
+    OnCompByContentCached(dummy);
+    OnOkay(dummy);
+}
+
+
 void ConfigDialog::onlTimeShiftKeyDown(wxKeyEvent& event)
 {
     const int keyCode = event.GetKeyCode();
@@ -631,6 +645,7 @@ void ConfigDialog::updateCompGui()
     m_toggleBtnByTimeSize->SetValue(false);
     m_toggleBtnBySize    ->SetValue(false);
     m_toggleBtnByContent ->SetValue(false);
+    m_toggleBtnByContentCached->SetValue(false);
 
     if (compOptionsEnabled) //help wxWidgets a little to render inactive config state (needed on Windows, NOT on Linux!)
         switch (localCmpVar_)
@@ -644,6 +659,9 @@ void ConfigDialog::updateCompGui()
             case CompareVariant::SIZE:
                 m_toggleBtnBySize->SetValue(true);
                 break;
+            case CompareVariant::CONTENT_CACHED:
+                m_toggleBtnByContentCached->SetValue(true);
+                break;
         }
 
     switch (localCmpVar_) //unconditionally update image, including "local options off"
@@ -652,6 +670,7 @@ void ConfigDialog::updateCompGui()
             setBitmap(*m_bitmapCompVariant, getResourceImage(L"cmp_file_time"));
             break;
         case CompareVariant::CONTENT:
+        case CompareVariant::CONTENT_CACHED:
             setBitmap(*m_bitmapCompVariant, getResourceImage(L"cmp_file_content"));
             break;
         case CompareVariant::SIZE:
@@ -1035,8 +1054,8 @@ void ConfigDialog::updateSyncGui()
         m_bitmapRightNewer  ->Show(activeCmpVar == CompareVariant::TIME_SIZE);
         m_bpButtonRightNewer->Show(activeCmpVar == CompareVariant::TIME_SIZE);
 
-        m_bitmapDifferent  ->Show(activeCmpVar == CompareVariant::CONTENT || activeCmpVar == CompareVariant::SIZE);
-        m_bpButtonDifferent->Show(activeCmpVar == CompareVariant::CONTENT || activeCmpVar == CompareVariant::SIZE);
+        m_bitmapDifferent  ->Show(activeCmpVar != CompareVariant::TIME_SIZE);
+        m_bpButtonDifferent->Show(activeCmpVar != CompareVariant::TIME_SIZE);
     }
 
     //active variant description:
@@ -0,0 +1,140 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef CONCURRENCY_LIMIT_H_2834750923475092384
+#define CONCURRENCY_LIMIT_H_2834750923475092384
+
+#include <chrono>
+#include "thread.h"
+
+
+namespace zen
+{
+/*
+limit the number of concurrent operations (e.g. file accesses on one device) and tune it at runtime, AIMD-style: thread-safe
+
+    - worker threads enclose each operation with acquire()/release(): at most getLimit() operations run at the same time
+    - per measurement interval compare throughput (operations/sec) and latency with the previous interval:
+        throughput down + latency up            => multiplicative decrease: limit / 2 (device is thrashing)
+        throughput up + limit was fully in use  => additive increase:       limit + 1 (also while below best limit)
+    - getBestLimit(): limit with the highest throughput seen so far => candidate for persisting in the configuration
+*/
+class AdaptiveConcurrencyLimit
+{
+public:
+    AdaptiveConcurrencyLimit(size_t limitInit, size_t limitMax) :
+        limitMax_(std::max<size_t>(limitMax, 1)),
+        limit_(std::clamp<size_t>(limitInit, 1, limitMax_)),
+        limitBest_(limit_) {}
+
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    //context of worker thread, blocking:
+    TimePoint acquire() //throw ThreadInterruption
+    {
+        std::unique_lock<std::mutex> dummy(lock_);
+        interruptibleWait(conditionBelowLimit_, dummy, [this] { return active_ < limit_; }); //throw ThreadInterruption
+
+        if (++active_ == limit_)
+            limitReached_ = true;
+        return std::chrono::steady_clock::now();
+    }
+
+    //context of worker thread:
+    void release(const TimePoint& startTime)
+    {
+        const TimePoint now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> dummy(lock_);
+            assert(active_ > 0);
+            --active_;
+            ++intervalOps_;
+            intervalLatency_ += now - startTime;
+
+            if (now - intervalStart_ >= MEASURE_INTERVAL && intervalOps_ >= MEASURE_OPS_MIN)
+                adaptLimit(now);
+        }
+        conditionBelowLimit_.notify_all(); //limit might have been increased
+    }
+
+    size_t getLimitMax() const { return limitMax_; }
+    size_t getLimit    () const { std::lock_guard<std::mutex> dummy(lock_); return limit_; }
+    size_t getBestLimit() const { std::lock_guard<std::mutex> dummy(lock_); return limitBest_; }
+
+private:
+    AdaptiveConcurrencyLimit           (const AdaptiveConcurrencyLimit&) = delete;
+    AdaptiveConcurrencyLimit& operator=(const AdaptiveConcurrencyLimit&) = delete;
+
+    static constexpr std::chrono::milliseconds MEASURE_INTERVAL{ 500 };
+    static constexpr size_t MEASURE_OPS_MIN = 10; //too few samples => keep measuring
+
+    void adaptLimit(const TimePoint& now)
+    {
+        const double throughput = intervalOps_ / std::chrono::duration<double>(now - intervalStart_).count();
+        const std::chrono::steady_clock::duration latency = intervalLatency_ / intervalOps_;
+
+        if (throughput > throughputBest_)
+        {
+            throughputBest_ = throughput;
+            limitBest_      = limit_;
+        }
+
+        if (throughputPrev_ > 0 &&
+            throughput < throughputPrev_ * 0.8 &&
+            latency    > latencyPrev_ * 1.2)
+            limit_ = std::max<size_t>(limit_ / 2, 1);
+        else if (limitReached_ && limit_ < limitMax_ &&    //no need to grow if the current limit is not even used
+                 (throughput > throughputPrev_ * 1.05 ||   //no gain from the last increase => stay (margin: measurement noise)
+                  limit_ < limitBest_))                    //recover after decrease: higher limit is known to perform better
+            ++limit_;
+
+        throughputPrev_ = throughput;
+        latencyPrev_    = latency;
+
+        intervalStart_   = now;
+        intervalOps_     = 0;
+        intervalLatency_ = {};
+        limitReached_    = active_ >= limit_;
+    }
+
+    const size_t limitMax_;
+
+    mutable std::mutex lock_;
+    std::condition_variable conditionBelowLimit_;
+
+    size_t limit_;
+    size_t active_ = 0;
+    bool limitReached_ = false;
+
+    TimePoint intervalStart_ = std::chrono::steady_clock::now();
+    size_t intervalOps_ = 0;
+    std::chrono::steady_clock::duration intervalLatency_{};
+
+    double throughputPrev_ = 0;
+    std::chrono::steady_clock::duration latencyPrev_{};
+
+    double throughputBest_ = 0;
+    size_t limitBest_;
+};
+
+
+//RAII: hold one operation slot while in scope
+class ConcurrencySlot
+{
+public:
+    explicit ConcurrencySlot(AdaptiveConcurrencyLimit* limit /*optional*/) : limit_(limit) { if (limit_) startTime_ = limit_->acquire(); } //throw ThreadInterruption
+    ~ConcurrencySlot() { if (limit_) limit_->release(startTime_); }
+
+private:
+    ConcurrencySlot           (const ConcurrencySlot&) = delete;
+    ConcurrencySlot& operator=(const ConcurrencySlot&) = delete;
+
+    AdaptiveConcurrencyLimit* const limit_;
+    AdaptiveConcurrencyLimit::TimePoint startTime_;
+};
+}
+
+#endif //CONCURRENCY_LIMIT_H_2834750923475092384
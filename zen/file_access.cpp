@@ -15,10 +15,15 @@
 #include "file_id_def.h"
 #include "file_io.h"
 #include "crc.h"
+#include "xxhash.h"
 #include "guid.h"
+#include "thread.h"
 
     #include <sys/vfs.h> //statfs
     #include <sys/time.h> //lutimes
+    #include <sys/ioctl.h> //ioctl
+    #include <sys/sendfile.h>
+    #include <linux/fs.h> //FICLONE
     #ifdef HAVE_SELINUX
         #include <selinux/selinux.h>
     #endif
@@ -623,13 +628,469 @@ void zen::copySymlink(const Zstring& sourceLink, const Zstring& targetLink, bool
 
 namespace
 {
+/*  Native file copy: use the cheapest method the file system supports:
+        1. reflink (FICLONE):  btrfs, XFS (reflink=1), OCFS2 => source and target share extents: no data is copied at all!
+        2. copy_file_range():  data stays in kernel space (+ server-side copy for NFS 4.2, CIFS)
+        3. sendfile():         same, but for Linux < 4.5
+        4. bufferedStreamCopy()
+    sparse source files: copy data extents only (SEEK_DATA/SEEK_HOLE) via copy_file_range() or pread()/pwrite() => holes stay unallocated
+    cache-neutral copy:  O_DIRECT for big files, else PageCacheEvictor
+    very large files:    copy ranges in parallel threads with pread()/pwrite() (fast devices, e.g. NVMe, RAID), but only if in-kernel copy is
+                         not supported: don't lose server-side copy (NFS, CIFS) and copy_file_range() reflinks
+    => failing syscalls on each file are not free: remember first working method per (source, target) volume pair */
+enum class NativeCopyMethod
+{
+    REFLINK,
+    COPY_FILE_RANGE,
+    SENDFILE,
+    BUFFERED,
+};
+
+using VolumePair = std::pair<VolumeId /*source*/, VolumeId /*target*/>;
+
+Protected<std::map<VolumePair, NativeCopyMethod>>& refNativeCopyMethods()
+{
+    static Protected<std::map<VolumePair, NativeCopyMethod>> nativeCopyMethods; //thread-safe init as per C++11
+    return nativeCopyMethods;
+}
+
+
+NativeCopyMethod getNativeCopyMethod(const VolumePair& volumes)
+{
+    return refNativeCopyMethods().access([&](const std::map<VolumePair, NativeCopyMethod>& methods)
+    {
+        auto it = methods.find(volumes);
+        return it != methods.end() ? it->second : NativeCopyMethod::REFLINK;
+    });
+}
+
+
+void setNativeCopyUnsupported(const VolumePair& volumes, NativeCopyMethod method)
+{
+    assert(method != NativeCopyMethod::BUFFERED);
+    refNativeCopyMethods().access([&](std::map<VolumePair, NativeCopyMethod>& methods)
+    {
+        NativeCopyMethod& nextMethod = methods.emplace(volumes, NativeCopyMethod::REFLINK).first->second;
+        nextMethod = std::max(nextMethod, static_cast<NativeCopyMethod>(static_cast<int>(method) + 1)); //parallel file copies may have come to the same conclusion
+    });
+}
+
+
+//error codes indicating missing support of file system (or kernel) rather than an I/O error:
+inline
+bool nativeCopyNotSupported(int ec)
+{
+    return ec == ENOSYS     || //kernel too old
+           ec == EOPNOTSUPP || //file system does not support operation (== ENOTSUP on Linux)
+           ec == ENOTTY     || //ioctl() not supported for file system
+           ec == EXDEV      || //different file systems: reflink, copy_file_range() on Linux < 5.3
+           ec == EINVAL;       //e.g. copy_file_range() on file systems without support
+}
+
+
+//return false if not supported (=> nothing was copied)
+bool tryCopyFileReflink(FileInput& fileIn, FileOutput& fileOut, uint64_t sourceSize, const VolumePair& volumes, //throw X
+                        const IOCallback& notifyUnbufferedIO)
+{
+    if (::ioctl(fileOut.getHandle(), FICLONE, fileIn.getHandle()) != 0)
+    {
+        if (nativeCopyNotSupported(errno))
+            setNativeCopyUnsupported(volumes, NativeCopyMethod::REFLINK);
+        //else: e.g. ENOSPC, EPERM, ETXTBSY: don't draw conclusions for the volume, but still give the other methods a try
+        return false;
+    }
+    if (notifyUnbufferedIO) notifyUnbufferedIO(sourceSize); //throw X
+    return true;
+}
+
+
+void throwCopyError(const FileInput& fileIn, const FileOutput& fileOut, const wchar_t* functionName, int ec) //throw FileError
+{
+    throw FileError(replaceCpy(replaceCpy(_("Cannot copy file %x to %y."), L"%x", L"\n" + fmtPath(fileIn.getFilePath())), L"%y", L"\n" + fmtPath(fileOut.getFilePath())),
+                    formatSystemError(functionName, ec));
+}
+
+
+//return false if not supported (=> nothing was copied)
+bool tryCopyFileKernel(FileInput& fileIn, FileOutput& fileOut, uint64_t sourceSize, const VolumePair& volumes, //throw FileError, X
+                       NativeCopyMethod method, const IOCallback& notifyUnbufferedIO)
+{
+    assert(method == NativeCopyMethod::COPY_FILE_RANGE || method == NativeCopyMethod::SENDFILE);
+    const wchar_t* functionName = method == NativeCopyMethod::COPY_FILE_RANGE ? L"copy_file_range" : L"sendfile";
+
+    const size_t blockSize = 8 * 1024 * 1024; //copy in chunks: allow for regular progress updates and cancellation
+    uint64_t bytesCopied = 0;
+    for (;;)
+    {
+        ssize_t bytesWritten = 0;
+        do
+        {
+            bytesWritten = method == NativeCopyMethod::COPY_FILE_RANGE ?
+                           ::copy_file_range(fileIn.getHandle(), nullptr, fileOut.getHandle(), nullptr, blockSize, 0 /*flags*/) :
+                           ::sendfile(fileOut.getHandle(), fileIn.getHandle(), nullptr, blockSize);
+        }
+        while (bytesWritten < 0 && errno == EINTR);
+
+        if (bytesWritten < 0)
+        {
+            const int ec = errno; //copy before making other system calls!
+            if (bytesCopied == 0 && nativeCopyNotSupported(ec))
+            {
+                setNativeCopyUnsupported(volumes, method);
+                return false;
+            }
+            throwCopyError(fileIn, fileOut, functionName, ec); //throw FileError
+        }
+
+        if (bytesWritten == 0) //end of file
+            //Linux 5.3 - 5.18: copy_file_range() returns 0 for files on special file systems, e.g. procfs, sysfs => fall back to buffered copy
+            return bytesCopied != 0 || sourceSize == 0;
+
+        bytesCopied += bytesWritten;
+        if (notifyUnbufferedIO) notifyUnbufferedIO(bytesWritten); //throw X
+    }
+}
+
+
+inline
+bool isSparseFile(const struct ::stat& fileInfo)
+{
+    return fileInfo.st_size > 0 && fileInfo.st_blocks * 512 < fileInfo.st_size; //st_blocks: number of 512B units allocated
+}
+
+
+//bypass page cache: read/write aligned blocks with O_DIRECT
+//return false if not supported (=> nothing was copied)
+bool tryCopyFileDirect(FileInput& fileIn, FileOutput& fileOut, uint64_t sourceSize, //throw FileError, X
+                       const IOCallback& notifyUnbufferedIO)
+{
+    const int fdIn  = fileIn .getHandle();
+    const int fdOut = fileOut.getHandle();
+
+    const int flagsIn  = ::fcntl(fdIn,  F_GETFL);
+    const int flagsOut = ::fcntl(fdOut, F_GETFL);
+    if (flagsIn == -1 || flagsOut == -1)
+        return false;
+
+    //fails with EINVAL on file systems without O_DIRECT support, e.g. tmpfs
+    if (::fcntl(fdIn, F_SETFL, flagsIn | O_DIRECT) != 0)
+        return false;
+    ZEN_ON_SCOPE_EXIT(::fcntl(fdIn, F_SETFL, flagsIn));
+
+    if (::fcntl(fdOut, F_SETFL, flagsOut | O_DIRECT) != 0)
+        return false;
+    ZEN_ON_SCOPE_EXIT(::fcntl(fdOut, F_SETFL, flagsOut));
+
+    //4 KiB alignment satisfies all common logical block sizes
+    const size_t alignment = 4096;
+    const size_t blockSize = 1024 * 1024;
+
+    void* bufRaw = nullptr;
+    if (::posix_memalign(&bufRaw, alignment, blockSize) != 0)
+        throw std::bad_alloc();
+    ZEN_ON_SCOPE_EXIT(::free(bufRaw));
+    auto buffer = static_cast<std::byte*>(bufRaw);
+
+    bool directIo = true;
+    uint64_t bytesCopied = 0;
+    for (;;)
+    {
+        ssize_t bytesRead = 0;
+        do
+            bytesRead = ::pread(fdIn, buffer, blockSize, bytesCopied);
+        while (bytesRead < 0 && errno == EINTR);
+        if (bytesRead < 0)
+            throwCopyError(fileIn, fileOut, L"pread", errno);
+
+        if (bytesRead == 0) //end of file
+            break;
+
+        size_t bytesToWrite = bytesRead;
+        if (directIo && bytesRead % alignment != 0)
+        {
+            if (bytesCopied + bytesRead < sourceSize) //unexpected short read (file size changed?) => offsets would become unaligned
+            {
+                ::fcntl(fdIn,  F_SETFL, flagsIn);
+                ::fcntl(fdOut, F_SETFL, flagsOut);
+                directIo = false;
+            }
+            else //last block: O_DIRECT requires aligned length => write padding, truncate later
+            {
+                bytesToWrite = (bytesRead + alignment - 1) / alignment * alignment;
+                std::memset(buffer + bytesRead, 0, bytesToWrite - bytesRead);
+            }
+        }
+
+        for (size_t pos = 0; pos < bytesToWrite;)
+        {
+            ssize_t bytesWritten = 0;
+            do
+                bytesWritten = ::pwrite(fdOut, buffer + pos, bytesToWrite - pos, bytesCopied + pos);
+            while (bytesWritten < 0 && errno == EINTR);
+            if (bytesWritten <= 0)
+                throwCopyError(fileIn, fileOut, L"pwrite", bytesWritten == 0 ? ENOSPC : errno); //comment in safe-read.c suggests to treat zero bytes written as an error due to buggy drivers
+            pos += bytesWritten;
+        }
+
+        bytesCopied += bytesRead;
+        if (notifyUnbufferedIO) notifyUnbufferedIO(bytesRead); //throw X
+    }
+
+    if (bytesCopied % alignment != 0) //remove padding
+        if (::ftruncate(fdOut, bytesCopied) != 0)
+            throwCopyError(fileIn, fileOut, L"ftruncate", errno);
+
+    return true;
+}
+
+
+//take up to "threadsMax" threads from a budget shared by concurrent copies; return number taken
+size_t acquireChunkedCopyThreads(std::atomic<size_t>& budget, size_t threadsMax)
+{
+    size_t available = budget;
+    size_t taken = 0;
+    do
+        taken = std::min(available, threadsMax);
+    while (!budget.compare_exchange_weak(available, available - taken));
+    return taken;
+}
+
+
+//split file into segments copied by "threadCount" worker threads; calling thread reports progress
+//=> caveat: target file is written out of order
+void copyFileChunked(FileInput& fileIn, FileOutput& fileOut, uint64_t sourceSize, size_t threadCount, bool cacheNeutral, //throw FileError, X
+                     const IOCallback& notifyUnbufferedIO)
+{
+    const int fdIn  = fileIn .getHandle();
+    const int fdOut = fileOut.getHandle();
+
+    fileOut.preAllocateSpaceBestEffort(sourceSize); //throw FileError
+
+    const uint64_t segmentSize = 8 * 1024 * 1024; //unit of work: small enough for load balancing, big enough for mostly sequential access
+    std::atomic<uint64_t> nextSegment{ 0 };
+    std::atomic<int64_t> bytesPending{ 0 }; //written by workers, not yet reported
+
+    std::mutex lockStatus;
+    std::condition_variable conditionWorkerDone;
+    size_t workersDone = 0;
+    std::exception_ptr workerError;
+
+    auto copySegments = [&] //throw FileError, ThreadInterruption
+    {
+        std::vector<std::byte> buffer(1024 * 1024);
+        for (;;)
+        {
+            interruptionPoint(); //throw ThreadInterruption
+
+            const uint64_t offset = nextSegment.fetch_add(segmentSize);
+            if (offset >= sourceSize)
+                return;
+            const uint64_t offsetEnd = std::min(offset + segmentSize, sourceSize);
+
+            for (uint64_t pos = offset; pos < offsetEnd;)
+            {
+                ssize_t bytesRead = 0;
+                do
+                    bytesRead = ::pread(fdIn, &buffer[0], static_cast<size_t>(std::min<uint64_t>(offsetEnd - pos, buffer.size())), pos);
+                while (bytesRead < 0 && errno == EINTR);
+                if (bytesRead < 0)
+                    throwCopyError(fileIn, fileOut, L"pread", errno);
+                if (bytesRead == 0) //source file was truncated while copying
+                    throwCopyError(fileIn, fileOut, L"pread", ENODATA);
+
+                for (ssize_t bufPos = 0; bufPos < bytesRead;)
+                {
+                    ssize_t bytesWritten = 0;
+                    do
+                        bytesWritten = ::pwrite(fdOut, &buffer[bufPos], bytesRead - bufPos, pos + bufPos);
+                    while (bytesWritten < 0 && errno == EINTR);
+                    if (bytesWritten <= 0)
+                        throwCopyError(fileIn, fileOut, L"pwrite", bytesWritten == 0 ? ENOSPC : errno); //comment in safe-read.c suggests to treat zero bytes written as an error due to buggy drivers
+                    bufPos += bytesWritten;
+                }
+                pos += bytesRead;
+                bytesPending += bytesRead;
+            }
+
+            if (cacheNeutral) //best effort
+            {
+                ::posix_fadvise(fdIn, offset, offsetEnd - offset, POSIX_FADV_DONTNEED);
+                ::sync_file_range(fdOut, offset, offsetEnd - offset, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+                ::posix_fadvise(fdOut, offset, offsetEnd - offset, POSIX_FADV_DONTNEED);
+            }
+        }
+    };
+
+    const size_t segmentCount = static_cast<size_t>((sourceSize + segmentSize - 1) / segmentSize);
+    threadCount = std::min(threadCount, segmentCount);
+
+    std::vector<InterruptibleThread> workers;
+    ZEN_ON_SCOPE_EXIT(
+    {
+        for (InterruptibleThread& wt : workers)
+            wt.interrupt(); //stop remaining workers early on error or cancellation
+        for (InterruptibleThread& wt : workers)
+            wt.join(); //workers are referencing local variables => must not outlive this scope!
+    });
+    for (size_t i = 0; i < threadCount; ++i)
+        workers.emplace_back([&]
+    {
+        setCurrentThreadName("Chunked File Copy");
+        try
+        {
+            copySegments(); //throw FileError, ThreadInterruption
+        }
+        catch (ThreadInterruption&) { throw; }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> dummy(lockStatus);
+            if (!workerError)
+                workerError = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> dummy(lockStatus);
+            ++workersDone;
+        }
+        conditionWorkerDone.notify_all();
+    });
+
+    for (;;)
+    {
+        bool done = false;
+        {
+            std::unique_lock<std::mutex> dummy(lockStatus);
+            done = conditionWorkerDone.wait_for(dummy, std::chrono::milliseconds(100), [&] { return workersDone == workers.size(); });
+            if (workerError)
+                std::rethrow_exception(workerError); //throw FileError
+        }
+        if (const int64_t bytesDelta = bytesPending.exchange(0))
+            if (notifyUnbufferedIO) notifyUnbufferedIO(bytesDelta); //throw X
+        if (done)
+            break;
+    }
+
+    //preallocation may have allocated more than needed:
+    if (::ftruncate(fdOut, sourceSize) != 0)
+        throwCopyError(fileIn, fileOut, L"ftruncate", errno);
+}
+
+
+//copy data extents only; holes are created by extending the target file (which must be new and empty)
+//=> progress: holes are reported as processed, so that total == sourceSize like for all other copy methods
+//return false if not supported (=> nothing was copied)
+bool tryCopyFileSparse(FileInput& fileIn, FileOutput& fileOut, uint64_t sourceSize, const VolumePair& volumes, //throw FileError, X
+                       const IOCallback& notifyUnbufferedIO)
+{
+    const int fdIn  = fileIn .getHandle();
+    const int fdOut = fileOut.getHandle();
+
+    off_t dataPos = ::lseek(fdIn, 0, SEEK_DATA);
+    if (dataPos < 0 && errno != ENXIO) //ENXIO: no data at all
+        return false; //EINVAL: SEEK_DATA not supported
+
+    if (::ftruncate(fdOut, sourceSize) != 0)
+        return false;
+
+    bool useCopyFileRange = getNativeCopyMethod(volumes) <= NativeCopyMethod::COPY_FILE_RANGE;
+    std::vector<std::byte> buffer; //for pread()/pwrite() fallback
+
+    uint64_t bytesProcessed = 0; //data + holes
+    while (dataPos >= 0 && makeUnsigned(dataPos) < sourceSize)
+    {
+        const off_t holePos = ::lseek(fdIn, dataPos, SEEK_HOLE); //there's always an implicit hole at the end of the file
+        if (holePos < 0)
+            throwCopyError(fileIn, fileOut, L"lseek(SEEK_HOLE)", errno);
+
+        if (notifyUnbufferedIO && makeUnsigned(dataPos) > bytesProcessed) notifyUnbufferedIO(dataPos - bytesProcessed); //throw X
+        bytesProcessed = dataPos;
+
+        const uint64_t extentEnd = std::min<uint64_t>(holePos, sourceSize);
+        while (bytesProcessed < extentEnd)
+        {
+            const size_t bytesToCopy = static_cast<size_t>(std::min<uint64_t>(extentEnd - bytesProcessed, 8 * 1024 * 1024)); //allow for regular progress updates and cancellation
+            ssize_t bytesWritten = 0;
+
+            if (useCopyFileRange)
+            {
+                loff_t offIn  = bytesProcessed;
+                loff_t offOut = bytesProcessed;
+                do
+                    bytesWritten = ::copy_file_range(fdIn, &offIn, fdOut, &offOut, bytesToCopy, 0 /*flags*/);
+                while (bytesWritten < 0 && errno == EINTR);
+
+                if (bytesWritten < 0)
+                {
+                    const int ec = errno; //copy before making other system calls!
+                    if (!nativeCopyNotSupported(ec))
+                        throwCopyError(fileIn, fileOut, L"copy_file_range", ec);
+
+                    setNativeCopyUnsupported(volumes, NativeCopyMethod::COPY_FILE_RANGE);
+                    useCopyFileRange = false; //explicit offsets => continue with pread()/pwrite() at same position
+                    continue;
+                }
+            }
+            else
+            {
+                const size_t blockSize = std::min(bytesToCopy, FileBase::getBlockSize());
+                buffer.resize(FileBase::getBlockSize());
+
+                ssize_t bytesRead = 0;
+                do
+                    bytesRead = ::pread(fdIn, &buffer[0], blockSize, bytesProcessed);
+                while (bytesRead < 0 && errno == EINTR);
+                if (bytesRead < 0)
+                    throwCopyError(fileIn, fileOut, L"pread", errno);
+
+                for (ssize_t pos = 0; pos < bytesRead; pos += bytesWritten)
+                {
+                    do
+                        bytesWritten = ::pwrite(fdOut, &buffer[pos], bytesRead - pos, bytesProcessed + pos);
+                    while (bytesWritten < 0 && errno == EINTR);
+                    if (bytesWritten <= 0)
+                        throwCopyError(fileIn, fileOut, L"pwrite", bytesWritten == 0 ? ENOSPC : errno); //comment in safe-read.c suggests to treat zero bytes written as an error due to buggy drivers
+                }
+                bytesWritten = bytesRead;
+            }
+
+            if (bytesWritten == 0) //source file was truncated while copying
+                throwCopyError(fileIn, fileOut, useCopyFileRange ? L"copy_file_range" : L"pread", ENODATA);
+
+            bytesProcessed += bytesWritten;
+            if (notifyUnbufferedIO) notifyUnbufferedIO(bytesWritten); //throw X
+        }
+
+        dataPos = ::lseek(fdIn, holePos, SEEK_DATA);
+        if (dataPos < 0 && errno != ENXIO) //ENXIO: no more data after holePos
+            throwCopyError(fileIn, fileOut, L"lseek(SEEK_DATA)", errno);
+    }
+
+    if (notifyUnbufferedIO && sourceSize > bytesProcessed) notifyUnbufferedIO(sourceSize - bytesProcessed); //throw X; trailing hole
+    return true;
+}
+
+
 FileCopyResult copyFileOsSpecific(const Zstring& sourceFile, //throw FileError, ErrorTargetExisting
                                   const Zstring& targetFile,
+                                  const FileCopyOptions& copyOptions,
                                   const IOCallback& notifyUnbufferedIO)
 {
     int64_t totalUnbufferedIO = 0;
 
-    FileInput fileIn(sourceFile, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //throw FileError, (ErrorFileLocked -> Windows-only)
+    const bool pipelinedCopy = copyOptions.pipelineBuffers >= 2;
+    IOCallbackAsync notifyReadAsync(IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //pipelined copy: FileInput::read() runs on worker thread
+    const IOCallback notifyRead = pipelinedCopy ? notifyReadAsync.getCallback() : IOCallback(IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO));
+
+    std::optional<PageCacheEvictor> evictIn;  //cache-neutral copy
+    std::optional<PageCacheEvictor> evictOut; //
+
+    FileInput fileIn(sourceFile, !copyOptions.cacheNeutral ? notifyRead : //throw FileError, (ErrorFileLocked -> Windows-only)
+                     IOCallback([&](int64_t bytesDelta)
+    {
+        evictIn->advance(bytesDelta);
+        notifyRead(bytesDelta); //throw X
+    }));
+    if (copyOptions.cacheNeutral)
+        evictIn.emplace(fileIn.getHandle(), false /*dirtyPages*/);
 
     struct ::stat sourceInfo = {};
     if (::fstat(fileIn.getHandle(), &sourceInfo) != 0)
@@ -655,19 +1116,119 @@ FileCopyResult copyFileOsSpecific(const Zstring& sourceFile, //throw FileError,
     catch (FileError&) {} );
     //place guard AFTER ::open() and BEFORE lifetime of FileOutput:
     //=> don't delete file that existed previously!!!
-    FileOutput fileOut(fdTarget, targetFile, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //pass ownership
+    if (copyOptions.cacheNeutral)
+        evictOut.emplace(fdTarget, true /*dirtyPages*/);
+
+    FileOutput fileOut(fdTarget, targetFile, !copyOptions.cacheNeutral ? IOCallback(IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)) : //pass ownership
+                       IOCallback([&, notifyWrite = IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)](int64_t bytesDelta) mutable
+    {
+        evictOut->advance(bytesDelta);
+        notifyWrite(bytesDelta); //throw X
+    }));
 
     //fileOut.preAllocateSpaceBestEffort(sourceInfo.st_size); //throw FileError
     //=> perf: seems like no real benefit...
 
-    bufferedStreamCopy(fileIn, fileOut); //throw FileError, (ErrorFileLocked), X
+    struct ::stat targetInfo = {};
+    if (::fstat(fileOut.getHandle(), &targetInfo) != 0)
+        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(targetFile)), L"fstat");
+
+    //native copy: report I/O directly: IOCallbackDivider expects a read and a write for each byte!
+    const VolumePair volumes(sourceInfo.st_dev, targetInfo.st_dev);
+    const uint64_t sourceSize = makeUnsigned(sourceInfo.st_size);
+    bool copyDone = false;
+
+    const IOCallback notifyNativeIO = !copyOptions.cacheNeutral ? notifyUnbufferedIO : [&](int64_t bytesDelta)
+    {
+        evictIn ->advance(bytesDelta);
+        evictOut->advance(bytesDelta);
+        if (notifyUnbufferedIO) notifyUnbufferedIO(bytesDelta); //throw X
+    };
+
+    //reflink shares extents => preserves holes, too
+    if (getNativeCopyMethod(volumes) == NativeCopyMethod::REFLINK)
+        copyDone = tryCopyFileReflink(fileIn, fileOut, sourceSize, volumes, notifyUnbufferedIO); //throw X
+
+    if (!copyDone && isSparseFile(sourceInfo))
+        copyDone = tryCopyFileSparse(fileIn, fileOut, sourceSize, volumes, notifyNativeIO); //throw FileError, X
+
+    if (!copyDone && copyOptions.cacheNeutral && copyOptions.directIoMinSize > 0 && sourceSize >= copyOptions.directIoMinSize)
+        copyDone = tryCopyFileDirect(fileIn, fileOut, sourceSize, notifyUnbufferedIO); //throw FileError, X
+
+    //copy_file_range() not supported (e.g. EXDEV, EOPNOTSUPP) => no server-side copy or reflink to lose: prefer parallel ranges over sendfile()
+    bool chunkedCopyTried = false;
+    auto tryCopyChunked = [&]
+    {
+        chunkedCopyTried = true;
+        if (copyOptions.chunkedCopyThreads < 2 || sourceSize < std::max<uint64_t>(copyOptions.chunkedCopyMinSize, 1))
+            return false;
+
+        const size_t threadCount = copyOptions.chunkedCopyThreadBudget ?
+                                   acquireChunkedCopyThreads(*copyOptions.chunkedCopyThreadBudget, copyOptions.chunkedCopyThreads) :
+                                   copyOptions.chunkedCopyThreads;
+        ZEN_ON_SCOPE_EXIT(if (copyOptions.chunkedCopyThreadBudget) *copyOptions.chunkedCopyThreadBudget += threadCount);
+
+        if (threadCount < 2) //budget used up by concurrent copies
+            return false;
+
+        copyFileChunked(fileIn, fileOut, sourceSize, threadCount, copyOptions.cacheNeutral, notifyUnbufferedIO); //throw FileError, X
+        return true;
+    };
+
+    switch (copyDone ? NativeCopyMethod::BUFFERED : getNativeCopyMethod(volumes))
+    {
+        case NativeCopyMethod::REFLINK:
+        case NativeCopyMethod::COPY_FILE_RANGE:
+            if (getNativeCopyMethod(volumes) <= NativeCopyMethod::COPY_FILE_RANGE &&
+                tryCopyFileKernel(fileIn, fileOut, sourceSize, volumes, NativeCopyMethod::COPY_FILE_RANGE, notifyNativeIO)) //throw FileError, X
+            {
+                copyDone = true;
+                break;
+            }
+            [[fallthrough]];
+        case NativeCopyMethod::SENDFILE:
+            if (tryCopyChunked() || //throw FileError, X
+                (getNativeCopyMethod(volumes) <= NativeCopyMethod::SENDFILE &&
+                 tryCopyFileKernel(fileIn, fileOut, sourceSize, volumes, NativeCopyMethod::SENDFILE, notifyNativeIO))) //throw FileError, X
+            {
+                copyDone = true;
+                break;
+            }
+            [[fallthrough]];
+        case NativeCopyMethod::BUFFERED:
+            break;
+    }
+
+    if (!copyDone && !chunkedCopyTried) //neither copy_file_range() nor sendfile() supported
+        copyDone = tryCopyChunked(); //throw FileError, X
+
+    std::optional<uint64_t> contentDigest;
+    if (!copyDone)
+    {
+        auto streamCopy = [&](auto& streamOut)
+        {
+            if (pipelinedCopy)
+                bufferedStreamCopyPipelined(fileIn, streamOut, copyOptions.pipelineBuffers, [&] { notifyReadAsync.flush(); /*throw X*/ }); //throw FileError, (ErrorFileLocked), X
+            else
+                bufferedStreamCopy(fileIn, streamOut); //throw FileError, (ErrorFileLocked), X
+        };
+
+        if (copyOptions.computeDigest) //data passes through user space anyway: hash for free
+        {
+            XxHash64 hasher;
+            HashingStreamOut hashingOut(fileOut, hasher);
+            streamCopy(hashingOut); //throw FileError, (ErrorFileLocked), X
+            contentDigest = hasher.finalize();
+        }
+        else
+            streamCopy(fileOut); //throw FileError, (ErrorFileLocked), X
+    }
 
     //flush intermediate buffers before fiddling with the raw file handle
     fileOut.flushBuffers(); //throw FileError, X
 
-    struct ::stat targetInfo = {};
-    if (::fstat(fileOut.getHandle(), &targetInfo) != 0)
-        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(targetFile)), L"fstat");
+    if (evictIn ) evictIn ->finalize();
+    if (evictOut) evictOut->finalize();
 
     //close output file handle before setting file time; also good place to catch errors when closing stream!
     fileOut.finalize(); //throw FileError, (X)  essentially a close() since  buffers were already flushed
@@ -693,6 +1254,7 @@ FileCopyResult copyFileOsSpecific(const Zstring& sourceFile, //throw FileError,
     result.sourceFileId = extractFileId(sourceInfo);
     result.targetFileId = extractFileId(targetInfo);
     result.errorModTime = errorModTime;
+    result.contentDigest = contentDigest;
     return result;
 }
 
@@ -711,9 +1273,10 @@ copyFileWindowsDefault(::CopyFileEx)  copyFileWindowsStream(::BackupRead/::Backu
 
 
 FileCopyResult zen::copyNewFile(const Zstring& sourceFile, const Zstring& targetFile, bool copyFilePermissions, //throw FileError, ErrorTargetExisting, ErrorFileLocked
+                                const FileCopyOptions& copyOptions,
                                 const IOCallback& notifyUnbufferedIO)
 {
-    const FileCopyResult result = copyFileOsSpecific(sourceFile, targetFile, notifyUnbufferedIO); //throw FileError, ErrorTargetExisting, ErrorFileLocked
+    const FileCopyResult result = copyFileOsSpecific(sourceFile, targetFile, copyOptions, notifyUnbufferedIO); //throw FileError, ErrorTargetExisting, ErrorFileLocked
 
     //at this point we know we created a new file, so it's fine to delete it for cleanup!
     ZEN_ON_SCOPE_FAIL(try { removeFilePlain(targetFile); }
@@ -8,6 +8,8 @@
 #define FILE_ACCESS_H_8017341345614857
 
 #include <functional>
+#include <atomic>
+#include <memory>
 #include "zstring.h"
 #include "file_error.h"
 #include "file_id_def.h"
@@ -98,9 +100,22 @@ struct FileCopyResult
     FileId sourceFileId;
     FileId targetFileId;
     std::optional<FileError> errorModTime; //failure to set modification time
+    std::optional<uint64_t> contentDigest; //XXH64 of the data written, if requested via FileCopyOptions::computeDigest
+};
+
+struct FileCopyOptions
+{
+    size_t pipelineBuffers = 0; //>= 2: read and write in parallel (source and target on different devices); see bufferedStreamCopyPipelined()
+    bool cacheNeutral = false; //evict source and target pages from the page cache as the copy advances
+    uint64_t directIoMinSize = 0; //cache-neutral copy: bypass page cache (O_DIRECT) for files of at least this size; 0: never
+    size_t chunkedCopyThreads = 0;   //>= 2: copy files of at least chunkedCopyMinSize in parallel ranges (pread/pwrite) if in-kernel copy is not supported
+    uint64_t chunkedCopyMinSize = 0; //
+    std::shared_ptr<std::atomic<size_t>> chunkedCopyThreadBudget; //optional: worker threads shared by all concurrent chunked copies, e.g. the device's parallel ops
+    bool computeDigest = false; //hash data if copied by buffered stream copy; no digest for native copy methods (reflink, copy_file_range, ...)
 };
 
 FileCopyResult copyNewFile(const Zstring& sourceFile, const Zstring& targetFile, bool copyFilePermissions, //throw FileError, ErrorTargetExisting, ErrorFileLocked
+                           const FileCopyOptions& copyOptions,
                            //accummulated delta != file size! consider ADS, sparse, compressed files
                            const IOCallback& notifyUnbufferedIO); //may be nullptr; throw X!
 }
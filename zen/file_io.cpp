@@ -6,6 +6,8 @@
 
 #include "file_io.h"
 #include "file_access.h"
+#include <thread>
+#include "io_uring.h"
 
     #include <sys/stat.h>
     #include <fcntl.h>  //open
@@ -73,6 +75,264 @@ void FileBase::close() //throw FileError
 
 //----------------------------------------------------------------------------------------------------
 
+/*
+io_uring-based read-ahead/write-behind: keep ASYNC_QUEUE_DEPTH blocks in flight per file
+    - one ring per thread, shared by all files the thread is reading/writing: e.g. source and target of a file copy, then the next file, ...
+        => io_uring_setup() + kernel worker pool are paid once per (long-lived) worker thread, not once per file
+    - requests use explicit offsets => file position is *not* updated while async I/O is active
+    - block buffers are swapped with FileInput/FileOutput::memBuf_ instead of copied
+*/
+namespace
+{
+std::atomic<bool> asyncFileIoEnabled{ false }; //std:atomic is uninitialized by default!
+
+
+struct AsyncRequest //user data of every request queued on a ThreadRing
+{
+    bool completed = false;
+    int result = 0; //"bytes transferred" or "-errno"
+};
+
+
+class ThreadRing
+{
+public:
+    static std::shared_ptr<ThreadRing> get() //return nullptr if not supported
+    {
+        thread_local std::shared_ptr<ThreadRing> ring; //shared ownership: AsyncFileIo may outlive thread_local destruction
+        thread_local bool setupFailed = false;
+
+        if (!asyncFileIoEnabled)
+            return nullptr;
+
+        if (!ring && !setupFailed && IoUring::isAvailable())
+            try
+            {
+                ring = std::make_shared<ThreadRing>(); //throw SysError
+            }
+            catch (SysError&) { setupFailed = true; } //fall back to blocking I/O; don't retry for each file
+        return ring;
+    }
+
+    ThreadRing() : ring_(RING_ENTRIES) {} //throw SysError
+
+    bool tryReserve(size_t requests)
+    {
+        if (requestsReserved_ + requests > ring_.getEntries())
+            return false; //too many files open on this thread
+        requestsReserved_ += requests;
+        return true;
+    }
+    void release(size_t requests) { assert(requestsReserved_ >= requests); requestsReserved_ -= requests; }
+
+    void submitRead (AsyncRequest& req, int fd,       void* buffer, size_t bytes, uint64_t offset) { req.completed = false; ring_.submitRead (fd, buffer, bytes, offset, reinterpret_cast<uintptr_t>(&req)); } //throw SysError
+    void submitWrite(AsyncRequest& req, int fd, const void* buffer, size_t bytes, uint64_t offset) { req.completed = false; ring_.submitWrite(fd, buffer, bytes, offset, reinterpret_cast<uintptr_t>(&req)); } //
+
+    //completions arrive in any order and may belong to other files on this thread => just mark them
+    void waitFor(const AsyncRequest& req) //throw SysError
+    {
+        while (!req.completed)
+        {
+            const IoUring::Completion c = ring_.waitCompletion(); //throw SysError
+            AsyncRequest& done = *reinterpret_cast<AsyncRequest*>(static_cast<uintptr_t>(c.userData));
+            done.completed = true;
+            done.result    = c.result;
+        }
+    }
+
+private:
+    ThreadRing           (const ThreadRing&) = delete;
+    ThreadRing& operator=(const ThreadRing&) = delete;
+
+    static const unsigned RING_ENTRIES = 32; //=> up to 8 files with async I/O per thread
+
+    IoUring ring_;
+    size_t requestsReserved_ = 0; //CONTRACT: pending requests <= ring entries
+};
+}
+
+
+void zen::enableAsyncFileIo(bool enable) { asyncFileIoEnabled = enable; }
+
+
+class zen::AsyncFileIo
+{
+public:
+    static std::unique_ptr<AsyncFileIo> create(FileBase::FileHandle fh, size_t blockSize) //return nullptr if not supported
+    {
+        std::shared_ptr<ThreadRing> ring = ThreadRing::get();
+        if (!ring)
+            return nullptr;
+
+        const off_t offset = ::lseek(fh, 0, SEEK_CUR);
+        if (offset < 0) //e.g. ESPIPE
+            return nullptr;
+
+        if (!ring->tryReserve(ASYNC_QUEUE_DEPTH))
+            return nullptr;
+        return std::make_unique<AsyncFileIo>(std::move(ring), fh, blockSize, offset);
+    }
+
+    AsyncFileIo(std::shared_ptr<ThreadRing>&& ring, FileBase::FileHandle fh, size_t blockSize, uint64_t offset) :
+        ring_(std::move(ring)),
+        fileHandle_(fh),
+        blockSize_(blockSize),
+        nextOffset_(offset),
+        blocks_(ASYNC_QUEUE_DEPTH, Block{ {}, std::vector<std::byte>(blockSize) }) {}
+
+    ~AsyncFileIo()
+    {
+        //kernel may still be accessing our buffers => must wait for pending requests before releasing memory!
+        try
+        {
+            discardPending(); //throw SysError
+        }
+        catch (SysError&) { assert(false); }
+
+        ring_->release(ASYNC_QUEUE_DEPTH);
+    }
+
+    //------------------------- read -------------------------
+    size_t readBlock(std::vector<std::byte>& buf) //throw SysError; only 0 means EOF!
+    {
+        assert(buf.size() == blockSize_ && std::this_thread::get_id() == threadId_);
+        if (endOfFile_)
+            return 0;
+
+        while (pendingCount_ < blocks_.size()) //read ahead
+        {
+            Block& b = blocks_[(front_ + pendingCount_) % blocks_.size()];
+            submit(b, nextOffset_, blockSize_, false /*isWrite*/); //throw SysError
+            nextOffset_ += blockSize_;
+        }
+
+        Block& b = blocks_[front_];
+        ring_->waitFor(b.req); //throw SysError
+        if (b.req.result < 0)
+            throw SysError(formatSystemError(L"io_uring(read)", -b.req.result));
+        const size_t bytesRead = b.req.result;
+        if (bytesRead > blockSize_) //better safe than sorry
+            throw SysError(L"io_uring(read): buffer overflow."); //user should never see this
+
+        buf.swap(b.buf);
+        const uint64_t offsetEnd = b.offset + bytesRead;
+        popFront();
+
+        if (bytesRead < blockSize_) //end of file or short read: discard read-ahead and continue at current position
+        {
+            discardPending(); //throw SysError
+            nextOffset_ = offsetEnd;
+            endOfFile_ = bytesRead == 0;
+        }
+        return bytesRead;
+    }
+
+    //------------------------- write -------------------------
+    //CONTRACT: buf.size() == block size; returns fresh buffer in "buf"
+    void writeBlock(std::vector<std::byte>& buf, size_t bytesToWrite, const IOCallback& notifyUnbufferedIO) //throw SysError, X
+    {
+        assert(buf.size() == blockSize_ && 0 < bytesToWrite && bytesToWrite <= blockSize_ && std::this_thread::get_id() == threadId_);
+        if (pendingCount_ == blocks_.size())
+            completeWrite(notifyUnbufferedIO); //throw SysError, X
+
+        Block& b = blocks_[(front_ + pendingCount_) % blocks_.size()];
+        buf.swap(b.buf);
+        submit(b, nextOffset_, bytesToWrite, true /*isWrite*/); //throw SysError
+        nextOffset_ += bytesToWrite;
+    }
+
+    //returns file position after last write
+    uint64_t flushWrites(const IOCallback& notifyUnbufferedIO) //throw SysError, X
+    {
+        while (pendingCount_ > 0)
+            completeWrite(notifyUnbufferedIO); //throw SysError, X
+        return nextOffset_;
+    }
+
+private:
+    AsyncFileIo           (const AsyncFileIo&) = delete;
+    AsyncFileIo& operator=(const AsyncFileIo&) = delete;
+
+    static const size_t ASYNC_QUEUE_DEPTH = 4;
+
+    struct Block
+    {
+        AsyncRequest req;
+        std::vector<std::byte> buf;
+        uint64_t offset = 0;
+        size_t   bytesRequested = 0;
+    };
+
+    void submit(Block& b, uint64_t offset, size_t bytes, bool isWrite) //throw SysError
+    {
+        b.offset         = offset;
+        b.bytesRequested = bytes;
+
+        if (isWrite)
+            ring_->submitWrite(b.req, fileHandle_, &b.buf[0], bytes, offset); //throw SysError
+        else
+            ring_->submitRead(b.req, fileHandle_, &b.buf[0], bytes, offset); //throw SysError
+        ++pendingCount_;
+    }
+
+    void popFront()
+    {
+        assert(pendingCount_ > 0);
+        front_ = (front_ + 1) % blocks_.size();
+        --pendingCount_;
+    }
+
+    void discardPending() //throw SysError
+    {
+        while (pendingCount_ > 0)
+        {
+            ring_->waitFor(blocks_[front_].req); //throw SysError
+            popFront();
+        }
+    }
+
+    void completeWrite(const IOCallback& notifyUnbufferedIO) //throw SysError, X
+    {
+        Block& b = blocks_[front_];
+        for (;;)
+        {
+            ring_->waitFor(b.req); //throw SysError
+            const int result = b.req.result;
+            if (result <= 0)
+                //comment in safe-read.c suggests to treat zero bytes written as an error due to buggy drivers
+                throw SysError(formatSystemError(L"io_uring(write)", result == 0 ? ENOSPC : -result));
+
+            const size_t bytesWritten = result;
+            if (bytesWritten > b.bytesRequested) //better safe than sorry
+                throw SysError(L"io_uring(write): buffer overflow."); //user should never see this
+
+            if (notifyUnbufferedIO) notifyUnbufferedIO(bytesWritten); //throw X!
+
+            if (bytesWritten == b.bytesRequested)
+                break;
+
+            //short write: re-submit remainder (only block in flight that is allowed to be re-used out of FIFO order)
+            std::memmove(&b.buf[0], &b.buf[0] + bytesWritten, b.bytesRequested - bytesWritten);
+            --pendingCount_;
+            submit(b, b.offset + bytesWritten, b.bytesRequested - bytesWritten, true /*isWrite*/); //throw SysError
+        }
+        popFront();
+    }
+
+    const std::shared_ptr<ThreadRing> ring_; //CONTRACT: use from creating thread only
+    const std::thread::id threadId_ = std::this_thread::get_id();
+    const FileBase::FileHandle fileHandle_;
+    const size_t blockSize_;
+    uint64_t nextOffset_;
+
+    std::vector<Block> blocks_; //FIFO: pending requests start at "front_"
+    size_t front_        = 0;
+    size_t pendingCount_ = 0;
+    bool endOfFile_ = false;
+};
+
+//----------------------------------------------------------------------------------------------------
+
 namespace
 {
 FileBase::FileHandle openHandleForRead(const Zstring& filePath) //throw FileError, ErrorFileLocked
@@ -92,6 +352,9 @@ FileInput::FileInput(FileHandle handle, const Zstring& filePath, const IOCallbac
     FileBase(handle, filePath), notifyUnbufferedIO_(notifyUnbufferedIO) {}
 
 
+FileInput::~FileInput() {} //std::unique_ptr<AsyncFileIo>: complete type needed
+
+
 FileInput::FileInput(const Zstring& filePath, const IOCallback& notifyUnbufferedIO) :
     FileBase(openHandleForRead(filePath), filePath), //throw FileError, ErrorFileLocked
     notifyUnbufferedIO_(notifyUnbufferedIO)
@@ -129,6 +392,27 @@ size_t FileInput::tryRead(void* buffer, size_t bytesToRead) //throw FileError, E
 }
 
 
+size_t FileInput::readBlock() //throw FileError, ErrorFileLocked
+{
+    if (asyncIo_)
+        try
+        {
+            return asyncIo_->readBlock(memBuf_); //throw SysError
+        }
+        catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(getFilePath())), e.toString()); }
+
+    const size_t bytesRead = tryRead(&memBuf_[0], getBlockSize()); //throw FileError, ErrorFileLocked; may return short, only 0 means EOF! => CONTRACT: bytesToRead > 0
+
+    //file is larger than a single block => worth queueing more read requests:
+    if (bytesRead == getBlockSize() && !asyncIoTried_)
+    {
+        asyncIoTried_ = true;
+        asyncIo_ = AsyncFileIo::create(getHandle(), getBlockSize());
+    }
+    return bytesRead;
+}
+
+
 size_t FileInput::read(void* buffer, size_t bytesToRead) //throw FileError, ErrorFileLocked, X; return "bytesToRead" bytes unless end of stream!
 {
     /*
@@ -144,8 +428,7 @@ size_t FileInput::read(void* buffer, size_t bytesToRead) //throw FileError, Erro
             - replacing std::copy() with memcpy() also *seems* to have improved speed "somewhat"
     */
 
-    const size_t blockSize = getBlockSize();
-    assert(memBuf_.size() >= blockSize);
+    assert(memBuf_.size() >= getBlockSize());
     assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= memBuf_.size());
 
     auto       it    = static_cast<std::byte*>(buffer);
@@ -160,7 +443,7 @@ size_t FileInput::read(void* buffer, size_t bytesToRead) //throw FileError, Erro
         if (it == itEnd)
             break;
         //--------------------------------------------------------------------
-        const size_t bytesRead = tryRead(&memBuf_[0], blockSize); //throw FileError, ErrorFileLocked; may return short, only 0 means EOF! => CONTRACT: bytesToRead > 0
+        const size_t bytesRead = readBlock(); //throw FileError, ErrorFileLocked; may return short, only 0 means EOF!
         bufPos_ = 0;
         bufPosEnd_ = bytesRead;
 
@@ -172,6 +455,33 @@ size_t FileInput::read(void* buffer, size_t bytesToRead) //throw FileError, Erro
     return it - static_cast<std::byte*>(buffer);
 }
 
+
+size_t FileInput::readAt(uint64_t offset, void* buffer, size_t bytesToRead) //throw FileError, X; return "bytesToRead" bytes unless end of file!
+{
+    size_t bytesReadTotal = 0;
+    while (bytesReadTotal < bytesToRead)
+    {
+        ssize_t bytesRead = 0;
+        do
+        {
+            bytesRead = ::pread(getHandle(), static_cast<std::byte*>(buffer) + bytesReadTotal, bytesToRead - bytesReadTotal, offset + bytesReadTotal);
+        }
+        while (bytesRead < 0 && errno == EINTR);
+
+        if (bytesRead < 0)
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(getFilePath())), L"pread");
+        if (static_cast<size_t>(bytesRead) > bytesToRead - bytesReadTotal) //better safe than sorry
+            throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(getFilePath())), L"pread: buffer overflow."); //user should never see this
+
+        if (notifyUnbufferedIO_) notifyUnbufferedIO_(bytesRead); //throw X
+
+        if (bytesRead == 0) //end of file
+            break;
+        bytesReadTotal += bytesRead;
+    }
+    return bytesReadTotal;
+}
+
 //----------------------------------------------------------------------------------------------------
 
 namespace
@@ -215,6 +525,8 @@ FileOutput::~FileOutput()
         flushBuffers(); //throw FileError, (X)
     }
     catch (...) { assert(false); }
+
+    asyncIo_.reset(); //wait for pending requests *before* FileBase closes the handle
 }
 
 
@@ -273,17 +585,64 @@ void FileOutput::write(const void* buffer, size_t bytesToWrite) //throw FileErro
         if (it == itEnd)
             return;
         //--------------------------------------------------------------------
-        const size_t bytesWritten = tryWrite(&memBuf_[bufPos_], blockSize); //throw FileError; may return short! CONTRACT: bytesToWrite > 0
-        bufPos_ += bytesWritten;
-        if (notifyUnbufferedIO_) notifyUnbufferedIO_(bytesWritten); //throw X!
+        writeBlock(); //throw FileError, X
     }
 }
 
 
+void FileOutput::writeBlock() //throw FileError, X
+{
+    assert(bufPosEnd_ - bufPos_ == getBlockSize());
+
+    //file is larger than a single block => worth queueing more write requests:
+    if (!asyncIo_ && !asyncIoTried_ && bufPos_ == 0)
+    {
+        asyncIoTried_ = true;
+        asyncIo_ = AsyncFileIo::create(getHandle(), getBlockSize());
+    }
+
+    if (asyncIo_)
+    {
+        assert(bufPos_ == 0);
+        try
+        {
+            asyncIo_->writeBlock(memBuf_, bufPosEnd_, notifyUnbufferedIO_); //throw SysError, X
+        }
+        catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(getFilePath())), e.toString()); }
+        bufPos_ = bufPosEnd_ = 0;
+        return;
+    }
+
+    const size_t bytesWritten = tryWrite(&memBuf_[bufPos_], getBlockSize()); //throw FileError; may return short! CONTRACT: bytesToWrite > 0
+    bufPos_ += bytesWritten;
+    if (notifyUnbufferedIO_) notifyUnbufferedIO_(bytesWritten); //throw X!
+}
+
+
 void FileOutput::flushBuffers() //throw FileError, X
 {
     assert(bufPosEnd_ - bufPos_ <= getBlockSize());
     assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= memBuf_.size());
+
+    if (asyncIo_)
+    {
+        try
+        {
+            if (bufPos_ != bufPosEnd_)
+            {
+                asyncIo_->writeBlock(memBuf_, bufPosEnd_, notifyUnbufferedIO_); //throw SysError, X
+                bufPos_ = bufPosEnd_ = 0;
+            }
+            const uint64_t filePos = asyncIo_->flushWrites(notifyUnbufferedIO_); //throw SysError, X
+
+            //keep file position consistent with blocking I/O:
+            if (::lseek(getHandle(), filePos, SEEK_SET) < 0)
+                THROW_LAST_SYS_ERROR(L"lseek");
+        }
+        catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(getFilePath())), e.toString()); }
+        return;
+    }
+
     while (bufPos_ != bufPosEnd_)
     {
         const size_t bytesWritten = tryWrite(&memBuf_[bufPos_], bufPosEnd_ - bufPos_); //throw FileError; may return short! CONTRACT: bytesToWrite > 0
@@ -296,11 +655,46 @@ void FileOutput::flushBuffers() //throw FileError, X
 void FileOutput::finalize() //throw FileError, X
 {
     flushBuffers(); //throw FileError, X
+    asyncIo_.reset(); //no more I/O on this handle
     //~FileBase() calls this one, too, but we want to propagate errors if any:
     close(); //throw FileError
 }
 
 
+void PageCacheEvictor::evict(bool finalize)
+{
+    //errors are ignored: we're only giving hints
+    if (dirtyPages_)
+    {
+        //POSIX_FADV_DONTNEED does not drop dirty pages => write back first:
+        //don't stall on the range just written: only start its writeback (SYNC_FILE_RANGE_WRITE), but wait for and
+        //evict the previous block, which had a full block's worth of writing time to complete
+        if (posWriteback_ > posEvicted_)
+        {
+            ::sync_file_range(fileHandle_, posEvicted_, posWriteback_ - posEvicted_, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+            ::posix_fadvise(fileHandle_, posEvicted_, posWriteback_ - posEvicted_, POSIX_FADV_DONTNEED);
+            posEvicted_ = posWriteback_;
+        }
+        if (posEnd_ > posWriteback_)
+        {
+            ::sync_file_range(fileHandle_, posWriteback_, posEnd_ - posWriteback_, finalize ?
+                              SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER :
+                              SYNC_FILE_RANGE_WRITE);
+            posWriteback_ = posEnd_;
+        }
+        if (!finalize)
+            return;
+    }
+
+    if (posEnd_ > posEvicted_)
+    {
+        ::posix_fadvise(fileHandle_, posEvicted_, posEnd_ - posEvicted_, POSIX_FADV_DONTNEED);
+        posEvicted_ = posWriteback_ = posEnd_;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+
 void FileOutput::preAllocateSpaceBestEffort(uint64_t expectedSize) //throw FileError
 {
     const FileHandle fh = getHandle();
@@ -7,6 +7,7 @@
 #ifndef FILE_IO_H_89578342758342572345
 #define FILE_IO_H_89578342758342572345
 
+#include <memory>
 #include "file_error.h"
 #include "serialize.h"
 
@@ -53,22 +54,36 @@ private:
 
 //-----------------------------------------------------------------------------------------------
 
+class AsyncFileIo; //io_uring: keep multiple blocks in flight for files larger than getBlockSize(); fallback: blocking read/write
+
+//process-wide, off by default: measured slower than blocking read/write for page-cached files and on a single core
+void enableAsyncFileIo(bool enable);
+
+
 class FileInput : public FileBase
 {
 public:
     FileInput(const Zstring& filePath, const IOCallback& notifyUnbufferedIO); //throw FileError, ErrorFileLocked
     FileInput(FileHandle handle, const Zstring& filePath, const IOCallback& notifyUnbufferedIO); //takes ownership!
+    ~FileInput();
 
     size_t read(void* buffer, size_t bytesToRead); //throw FileError, ErrorFileLocked, X; return "bytesToRead" bytes unless end of stream!
 
+    //positional read, e.g. file samples: bypasses read buffer, file position unchanged
+    size_t readAt(uint64_t offset, void* buffer, size_t bytesToRead); //throw FileError, X; return "bytesToRead" bytes unless end of file!
+
 private:
     size_t tryRead(void* buffer, size_t bytesToRead); //throw FileError, ErrorFileLocked; may return short, only 0 means EOF! =>  CONTRACT: bytesToRead > 0!
+    size_t readBlock(); //throw FileError, ErrorFileLocked; fill memBuf_
 
     const IOCallback notifyUnbufferedIO_; //throw X
 
     std::vector<std::byte> memBuf_ = std::vector<std::byte>(getBlockSize());
     size_t bufPos_   = 0;
     size_t bufPosEnd_= 0;
+
+    std::unique_ptr<AsyncFileIo> asyncIo_;
+    bool asyncIoTried_ = false;
 };
 
 
@@ -92,12 +107,49 @@ public:
 
 private:
     size_t tryWrite(const void* buffer, size_t bytesToWrite); //throw FileError; may return short! CONTRACT: bytesToWrite > 0
+    void writeBlock(); //throw FileError, X; write full memBuf_
 
     IOCallback notifyUnbufferedIO_; //throw X
 
     std::vector<std::byte> memBuf_ = std::vector<std::byte>(getBlockSize());
     size_t bufPos_    = 0;
     size_t bufPosEnd_ = 0;
+
+    std::unique_ptr<AsyncFileIo> asyncIo_;
+    bool asyncIoTried_ = false;
+};
+
+//-----------------------------------------------------------------------------------------------
+
+//cache-neutral I/O: evict pages behind the current position of a sequentially read or written file (best effort)
+//=> bulk copies don't push other applications' data out of the page cache
+class PageCacheEvictor
+{
+public:
+    PageCacheEvictor(FileBase::FileHandle fileHandle, bool dirtyPages /*= file is written*/) : fileHandle_(fileHandle), dirtyPages_(dirtyPages) {}
+
+    void advance(int64_t bytesDelta) //bytes processed sequentially from the start of the file
+    {
+        posEnd_ += bytesDelta;
+        if (posEnd_ - posWriteback_ >= EVICT_BLOCK_SIZE) //not posEvicted_: would wait on the block just submitted for writeback
+            evict(false /*finalize*/);
+    }
+
+    void finalize() { evict(true); } //call before closing the file handle
+
+private:
+    PageCacheEvictor           (const PageCacheEvictor&) = delete;
+    PageCacheEvictor& operator=(const PageCacheEvictor&) = delete;
+
+    void evict(bool finalize);
+
+    static const uint64_t EVICT_BLOCK_SIZE = 8 * 1024 * 1024;
+
+    const FileBase::FileHandle fileHandle_;
+    const bool dirtyPages_;
+    uint64_t posWriteback_ = 0; //[posEvicted_, posWriteback_): writeback already started (trails posEnd_ by up to one block)
+    uint64_t posEvicted_   = 0;
+    uint64_t posEnd_       = 0;
 };
 
 //-----------------------------------------------------------------------------------------------
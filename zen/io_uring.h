@@ -0,0 +1,187 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef IO_URING_H_7340958723409857234095
+#define IO_URING_H_7340958723409857234095
+
+#include <atomic>
+#include "sys_error.h"
+#include "scope_guard.h"
+    #include <unistd.h> //close, syscall
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <linux/io_uring.h>
+
+
+namespace zen
+{
+/*
+minimal io_uring wrapper: queue file reads/writes at explicit offsets and reap completions
+    - raw syscalls: no dependency on liburing
+    - not thread-safe: one instance per thread
+    - kernel support is detected at runtime: see isAvailable()
+*/
+class IoUring //throw SysError
+{
+public:
+    //false if io_uring is known to be missing, disabled (sysctl kernel.io_uring_disabled) or blocked (seccomp)
+    static bool isAvailable() { return !refUnavailable(); }
+
+    explicit IoUring(unsigned entries) //throw SysError
+    {
+        ::io_uring_params params = {};
+        ringFd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (ringFd_ < 0)
+        {
+            const ErrorCode ec = getLastError(); //copy before making other system calls!
+            if (ec == ENOSYS || ec == EPERM || ec == EACCES) //=> don't try again
+                refUnavailable() = true;
+            throw SysError(formatSystemError(L"io_uring_setup", ec));
+        }
+        ZEN_ON_SCOPE_FAIL(::close(ringFd_));
+
+        //IORING_OP_READ/IORING_OP_WRITE require Linux 5.6, same as IORING_FEAT_RW_CUR_POS
+        if (!(params.features & IORING_FEAT_RW_CUR_POS))
+        {
+            refUnavailable() = true;
+            throw SysError(L"io_uring_setup: IORING_OP_READ/IORING_OP_WRITE not supported.");
+        }
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes  + params.cq_entries * sizeof(::io_uring_cqe);
+        sqesSize_   = params.sq_entries * sizeof(::io_uring_sqe);
+
+        sqRing_ = mapRing(sqRingSize_, IORING_OFF_SQ_RING); //throw SysError
+        ZEN_ON_SCOPE_FAIL(::munmap(sqRing_, sqRingSize_));
+
+        cqRing_ = mapRing(cqRingSize_, IORING_OFF_CQ_RING); //throw SysError
+        ZEN_ON_SCOPE_FAIL(::munmap(cqRing_, cqRingSize_));
+
+        sqes_ = static_cast<::io_uring_sqe*>(mapRing(sqesSize_, IORING_OFF_SQES)); //throw SysError
+
+        sqTail_  = ringPtr<unsigned>(sqRing_, params.sq_off.tail);
+        sqMask_  = *ringPtr<unsigned>(sqRing_, params.sq_off.ring_mask);
+        sqArray_ = ringPtr<unsigned>(sqRing_, params.sq_off.array);
+        cqHead_  = ringPtr<unsigned>(cqRing_, params.cq_off.head);
+        cqTail_  = ringPtr<unsigned>(cqRing_, params.cq_off.tail);
+        cqMask_  = *ringPtr<unsigned>(cqRing_, params.cq_off.ring_mask);
+        cqes_    = ringPtr<::io_uring_cqe>(cqRing_, params.cq_off.cqes);
+        entries_ = params.sq_entries;
+    }
+
+    ~IoUring()
+    {
+        ::munmap(sqes_,   sqesSize_);
+        ::munmap(cqRing_, cqRingSize_);
+        ::munmap(sqRing_, sqRingSize_);
+        ::close(ringFd_); //closing the ring cancels pending requests (and waits for those referencing user memory)
+    }
+
+    //CONTRACT: at most "entries" requests pending at a time
+    void submitRead (int fd,       void* buffer, size_t bytesToRead,  uint64_t offset, uint64_t userData) { submit(IORING_OP_READ,  fd, buffer, bytesToRead, offset, userData); } //throw SysError
+    void submitWrite(int fd, const void* buffer, size_t bytesToWrite, uint64_t offset, uint64_t userData) { submit(IORING_OP_WRITE, fd, buffer, bytesToWrite, offset, userData); } //
+
+    struct Completion
+    {
+        uint64_t userData = 0;
+        int result = 0; //"bytes transferred" or "-errno"
+    };
+    Completion waitCompletion() //throw SysError
+    {
+        for (;;)
+        {
+            const unsigned head = *cqHead_; //we're the only consumer
+            if (head != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE))
+            {
+                const ::io_uring_cqe& cqe = cqes_[head & cqMask_];
+                const Completion c{ cqe.user_data, cqe.res };
+                __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+                return c;
+            }
+            enter(0 /*toSubmit*/, 1 /*minComplete*/, IORING_ENTER_GETEVENTS); //throw SysError
+        }
+    }
+
+    unsigned getEntries() const { return entries_; }
+
+private:
+    IoUring           (const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    static std::atomic<bool>& refUnavailable()
+    {
+        static std::atomic<bool> unavailable{ false };
+        return unavailable;
+    }
+
+    void* mapRing(size_t size, off_t offset) //throw SysError
+    {
+        void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, offset);
+        if (ptr == MAP_FAILED)
+            THROW_LAST_SYS_ERROR(L"mmap");
+        return ptr;
+    }
+
+    template <class T>
+    static T* ringPtr(void* ring, unsigned offset) { return reinterpret_cast<T*>(static_cast<char*>(ring) + offset); }
+
+    void submit(unsigned char opCode, int fd, const void* buffer, size_t bytes, uint64_t offset, uint64_t userData) //throw SysError
+    {
+        const unsigned tail = *sqTail_; //we're the only producer
+        const unsigned idx = tail & sqMask_;
+
+        ::io_uring_sqe& sqe = sqes_[idx];
+        sqe = {};
+        sqe.opcode    = opCode;
+        sqe.fd        = fd;
+        sqe.addr      = reinterpret_cast<uintptr_t>(buffer);
+        sqe.len       = static_cast<unsigned>(bytes);
+        sqe.off       = offset;
+        sqe.user_data = userData;
+
+        sqArray_[idx] = idx;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+
+        enter(1 /*toSubmit*/, 0 /*minComplete*/, 0); //throw SysError
+    }
+
+    void enter(unsigned toSubmit, unsigned minComplete, unsigned flags) //throw SysError
+    {
+        for (;;)
+        {
+            const long rv = ::syscall(__NR_io_uring_enter, ringFd_, toSubmit, minComplete, flags, nullptr, 0);
+            if (rv >= 0)
+            {
+                if (static_cast<unsigned long>(rv) != toSubmit) //SQE consumed, but kernel failed to queue it (e.g. -EAGAIN)
+                    throw SysError(L"io_uring_enter: request not submitted.");
+                return;
+            }
+            if (errno != EINTR)
+                THROW_LAST_SYS_ERROR(L"io_uring_enter");
+        }
+    }
+
+    int ringFd_ = -1;
+    unsigned entries_ = 0;
+
+    void*  sqRing_     = nullptr;
+    size_t sqRingSize_ = 0;
+    void*  cqRing_     = nullptr;
+    size_t cqRingSize_ = 0;
+    ::io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_   = 0;
+
+    unsigned* sqTail_  = nullptr;
+    unsigned  sqMask_  = 0;
+    unsigned* sqArray_ = nullptr;
+    unsigned* cqHead_  = nullptr;
+    unsigned* cqTail_  = nullptr;
+    unsigned  cqMask_  = 0;
+    ::io_uring_cqe* cqes_ = nullptr;
+};
+}
+
+#endif //IO_URING_H_7340958723409857234095
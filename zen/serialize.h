@@ -9,7 +9,13 @@
 
 #include <functional>
 #include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include "string_base.h"
+#include "scope_guard.h"
+#include "thread.h"
 //keep header clean from specific stream implementations! (e.g.file_io.h)! used by abstract.h!
 
 
@@ -86,6 +92,13 @@ using IOCallback = std::function<void(int64_t bytesDelta)>; //throw X
 template <class BufferedInputStream, class BufferedOutputStream>
 void bufferedStreamCopy(BufferedInputStream& streamIn, BufferedOutputStream& streamOut); //throw X
 
+//same as bufferedStreamCopy(), but read and write in parallel using a ring of "bufferCount" blocks: e.g. source and target on different disks
+//- streamIn.read() runs on a worker thread => streamIn's IOCallback must be thread-safe, see IOCallbackAsync
+//- onUpdate: called regularly on the calling thread, e.g. to forward IOCallbackAsync notifications
+template <class BufferedInputStream, class BufferedOutputStream>
+void bufferedStreamCopyPipelined(BufferedInputStream& streamIn, BufferedOutputStream& streamOut, size_t bufferCount, //throw X
+                                 const std::function<void()>& onUpdate /*throw X; optional*/);
+
 template <class BinContainer, class BufferedInputStream> BinContainer
 bufferedLoad(BufferedInputStream& streamIn); //throw X
 
@@ -114,6 +127,48 @@ private:
     const IOCallback& notifyUnbufferedIO_;
 };
 
+
+//IOCallback for use on a worker thread: collect bytes and let the owning thread report them
+class IOCallbackAsync
+{
+public:
+    IOCallbackAsync(const IOCallback& notifyUnbufferedIO) : notifyUnbufferedIO_(notifyUnbufferedIO) {}
+
+    IOCallback getCallback() { return [this](int64_t bytesDelta) { bytesPending_ += bytesDelta; }; } //thread-safe, noexcept
+
+    //context of owning thread:
+    void flush() //throw X
+    {
+        if (const int64_t bytesDelta = bytesPending_.exchange(0))
+            if (notifyUnbufferedIO_) notifyUnbufferedIO_(bytesDelta); //throw X
+    }
+
+private:
+    IOCallbackAsync           (const IOCallbackAsync&) = delete;
+    IOCallbackAsync& operator=(const IOCallbackAsync&) = delete;
+
+    std::atomic<int64_t> bytesPending_{ 0 };
+    const IOCallback notifyUnbufferedIO_;
+};
+
+
+//pass-through output stream: hash data on its way to the target, e.g. zen::XxHash64
+template <class BufferedOutputStream, class Hasher>
+struct HashingStreamOut
+{
+    HashingStreamOut(BufferedOutputStream& streamOut, Hasher& hasher) : streamOut_(streamOut), hasher_(hasher) {}
+
+    void write(const void* buffer, size_t bytesToWrite) //throw X
+    {
+        hasher_.update(buffer, bytesToWrite);
+        streamOut_.write(buffer, bytesToWrite); //throw X
+    }
+
+private:
+    BufferedOutputStream& streamOut_;
+    Hasher& hasher_;
+};
+
 //buffered input/output stream reference implementations:
 template <class BinContainer>
 struct MemoryStreamIn
@@ -192,6 +247,109 @@ void bufferedStreamCopy(BufferedInputStream& streamIn,   //throw X
 }
 
 
+template <class BufferedInputStream, class BufferedOutputStream> inline
+void bufferedStreamCopyPipelined(BufferedInputStream& streamIn,   //throw X
+                                 BufferedOutputStream& streamOut, //
+                                 size_t bufferCount,
+                                 const std::function<void()>& onUpdate) //throw X
+{
+    if (bufferCount < 2)
+    {
+        bufferedStreamCopy(streamIn, streamOut); //throw X
+        if (onUpdate) onUpdate(); //throw X
+        return;
+    }
+
+    const size_t blockSize = streamIn.getBlockSize();
+    if (blockSize == 0)
+        throw std::logic_error("Contract violation! " + std::string(__FILE__) + ":" + numberTo<std::string>(__LINE__));
+
+    struct Block
+    {
+        std::vector<std::byte> buffer;
+        size_t bytesUsed = 0;
+    };
+    std::vector<Block> blocks(bufferCount, Block{ std::vector<std::byte>(blockSize) });
+
+    std::mutex lockBlocks;
+    std::condition_variable conditionBlockFree;
+    std::condition_variable conditionBlockFilled;
+    size_t blocksFilled = 0; //number of blocks ready for writing, starting at index "writePos"
+    size_t writePos     = 0; //
+    std::exception_ptr readError;
+
+    InterruptibleThread reader([&]
+    {
+        setCurrentThreadName("Stream Reader");
+        try
+        {
+            for (size_t readPos = 0;; readPos = (readPos + 1) % bufferCount)
+            {
+                {
+                    std::unique_lock<std::mutex> dummy(lockBlocks);
+                    interruptibleWait(conditionBlockFree, dummy, [&] { return blocksFilled < bufferCount; }); //throw ThreadInterruption
+                }
+                //block at readPos is owned exclusively by reader thread until it's marked "filled":
+                Block& block = blocks[readPos];
+                block.bytesUsed = streamIn.read(&block.buffer[0], blockSize); //throw X; return "bytesToRead" bytes unless end of stream!
+                {
+                    std::lock_guard<std::mutex> dummy(lockBlocks);
+                    ++blocksFilled;
+                }
+                conditionBlockFilled.notify_all();
+
+                if (block.bytesUsed < blockSize) //end of file
+                    return;
+            }
+        }
+        catch (ThreadInterruption&) { throw; }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> dummy(lockBlocks);
+                readError = std::current_exception();
+            }
+            conditionBlockFilled.notify_all();
+        }
+    });
+    ZEN_ON_SCOPE_EXIT(
+        reader.interrupt(); //e.g. user cancel: don't wait for the remaining blocks
+        reader.join(); //reader is referencing streamIn and blocks => must not outlive this scope!
+    );
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> dummy(lockBlocks);
+            //give caller a chance to report progress from the reader thread:
+            while (!conditionBlockFilled.wait_for(dummy, std::chrono::milliseconds(100), [&] { return blocksFilled > 0 || readError; }))
+            {
+                dummy.unlock();
+                if (onUpdate) onUpdate(); //throw X
+                dummy.lock();
+            }
+            if (readError)
+                std::rethrow_exception(readError); //throw X
+        }
+        //block at writePos is owned exclusively by writer thread until it's released:
+        const Block& block = blocks[writePos];
+        streamOut.write(&block.buffer[0], block.bytesUsed); //throw X
+        if (onUpdate) onUpdate(); //throw X
+
+        const bool eof = block.bytesUsed < blockSize;
+        {
+            std::lock_guard<std::mutex> dummy(lockBlocks);
+            --blocksFilled;
+        }
+        conditionBlockFree.notify_all();
+        writePos = (writePos + 1) % bufferCount;
+
+        if (eof)
+            break;
+    }
+}
+
+
 template <class BinContainer, class BufferedInputStream> inline
 BinContainer bufferedLoad(BufferedInputStream& streamIn) //throw X
 {
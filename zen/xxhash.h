@@ -0,0 +1,147 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef XXHASH_H_8723498572340598723450
+#define XXHASH_H_8723498572340598723450
+
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+
+
+namespace zen
+{
+/*
+streaming XXH64: fast non-cryptographic hash for detecting content differences (not tampering!)
+    https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+
+    XxHash64 hasher;
+    hasher.update(buf, len); ...
+    const uint64_t hash = hasher.finalize();
+*/
+class XxHash64
+{
+public:
+    explicit XxHash64(uint64_t seed = 0) : acc_{ seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1 }, seed_(seed) {}
+
+    void update(const void* buffer, size_t bytesToHash);
+
+    uint64_t finalize() const; //may be called repeatedly
+
+private:
+    static constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    static uint64_t round(uint64_t acc, uint64_t input)
+    {
+        acc += input * PRIME2;
+        return rotl(acc, 31) * PRIME1;
+    }
+
+    static uint64_t mergeRound(uint64_t acc, uint64_t val)
+    {
+        acc ^= round(0, val);
+        return acc * PRIME1 + PRIME4;
+    }
+
+    //XXH64 is specified for little-endian input
+    static uint64_t readLE64(const unsigned char* ptr) { uint64_t val = 0; std::memcpy(&val, ptr, sizeof(val)); return val; }
+    static uint32_t readLE32(const unsigned char* ptr) { uint32_t val = 0; std::memcpy(&val, ptr, sizeof(val)); return val; }
+
+    void consumeStripe(const unsigned char* ptr)
+    {
+        for (int i = 0; i < 4; ++i)
+            acc_[i] = round(acc_[i], readLE64(ptr + 8 * i));
+    }
+
+    uint64_t acc_[4];
+    const uint64_t seed_;
+    uint64_t totalBytes_ = 0;
+    unsigned char stripe_[32]; //pending input of less than a full stripe
+    size_t stripeBytes_ = 0;
+};
+
+//------------------------- implementation -------------------------------
+inline
+void XxHash64::update(const void* buffer, size_t bytesToHash)
+{
+    const unsigned char*       it  = static_cast<const unsigned char*>(buffer);
+    const unsigned char* const end = it + bytesToHash;
+    totalBytes_ += bytesToHash;
+
+    if (stripeBytes_ > 0)
+    {
+        const size_t chunkSize = std::min(bytesToHash, sizeof(stripe_) - stripeBytes_);
+        std::memcpy(stripe_ + stripeBytes_, it, chunkSize);
+        stripeBytes_ += chunkSize;
+        it += chunkSize;
+
+        if (stripeBytes_ < sizeof(stripe_))
+            return;
+
+        consumeStripe(stripe_);
+        stripeBytes_ = 0;
+    }
+
+    for (; static_cast<size_t>(end - it) >= sizeof(stripe_); it += sizeof(stripe_))
+        consumeStripe(it);
+
+    std::memcpy(stripe_, it, end - it);
+    stripeBytes_ = end - it;
+}
+
+
+inline
+uint64_t XxHash64::finalize() const
+{
+    uint64_t hash = 0;
+    if (totalBytes_ >= sizeof(stripe_))
+    {
+        hash = rotl(acc_[0], 1) + rotl(acc_[1], 7) + rotl(acc_[2], 12) + rotl(acc_[3], 18);
+        for (uint64_t acc : acc_)
+            hash = mergeRound(hash, acc);
+    }
+    else
+        hash = seed_ + PRIME5;
+
+    hash += totalBytes_;
+
+    const unsigned char* it = stripe_;
+    size_t bytesLeft = stripeBytes_;
+
+    for (; bytesLeft >= 8; it += 8, bytesLeft -= 8)
+    {
+        hash ^= round(0, readLE64(it));
+        hash = rotl(hash, 27) * PRIME1 + PRIME4;
+    }
+    if (bytesLeft >= 4)
+    {
+        hash ^= static_cast<uint64_t>(readLE32(it)) * PRIME1;
+        hash = rotl(hash, 23) * PRIME2 + PRIME3;
+        it += 4;
+        bytesLeft -= 4;
+    }
+    for (; bytesLeft > 0; ++it, --bytesLeft)
+    {
+        hash ^= *it * PRIME5;
+        hash = rotl(hash, 11) * PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+}
+
+#endif //XXHASH_H_8723498572340598723450